@@ -0,0 +1,403 @@
+// Headless benchmark for CQPaletteArea operations
+//
+// Runs on the offscreen QPA platform (unless QT_QPA_PLATFORM is already set)
+// and reports min/median/p99 timings (milliseconds) for each operation as
+// JSON (default) or CSV (-csv).
+//
+// Usage: CQPaletteAreaBench [-csv] [-iterations <n>]
+
+#include <CQPaletteArea.h>
+#include <CQPaletteGroup.h>
+
+#include <QApplication>
+#include <QMainWindow>
+#include <QMouseEvent>
+#include <QElapsedTimer>
+#include <QVBoxLayout>
+#include <QPushButton>
+
+#include <algorithm>
+#include <functional>
+#include <iostream>
+#include <cmath>
+#include <cstring>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace {
+
+//! simple page with a few child widgets
+class BenchPage : public CQPaletteAreaPage {
+ public:
+  BenchPage(int ind) :
+   CQPaletteAreaPage(new QWidget), ind_(ind) {
+    QWidget *w = widget();
+
+    w->setObjectName(QString("page%1").arg(ind_));
+
+    QVBoxLayout *layout = new QVBoxLayout(w);
+    layout->setMargin(2); layout->setSpacing(2);
+
+    layout->addWidget(new QPushButton("Button 1"));
+    layout->addWidget(new QPushButton("Button 2"));
+    layout->addStretch();
+  }
+
+  QString title      () const override { return QString("Page %1").arg(ind_); }
+  QString windowTitle() const override { return QString("Page %1 Window").arg(ind_); }
+
+ private:
+  int ind_ { 0 };
+};
+
+//------
+
+//! main window, manager and pages for one benchmark
+class BenchFixture {
+ public:
+  typedef std::vector<CQPaletteAreaPage *> Pages;
+
+ public:
+  BenchFixture() {
+    window_ = new QMainWindow;
+
+    window_->setObjectName("window");
+
+    QWidget *central = new QWidget;
+
+    central->setObjectName("central");
+
+    window_->setCentralWidget(central);
+
+    window_->resize(1200, 800);
+
+    mgr_ = new CQPaletteAreaMgr(window_);
+
+    window_->show();
+
+    flush();
+  }
+
+ ~BenchFixture() {
+    delete mgr_;
+    delete window_;
+
+    for (auto &page : pages_)
+      delete page;
+  }
+
+  QMainWindow *window() const { return window_; }
+
+  CQPaletteAreaMgr *mgr() const { return mgr_; }
+
+  const Pages &pages() const { return pages_; }
+
+  CQPaletteAreaPage *createPage() {
+    CQPaletteAreaPage *page = new BenchPage(int(pages_.size()));
+
+    pages_.push_back(page);
+
+    return page;
+  }
+
+  void addPages(int n, Qt::DockWidgetArea dockArea) {
+    for (int i = 0; i < n; ++i)
+      mgr_->addPage(createPage(), dockArea);
+  }
+
+  // process pending events (including deferred deletes)
+  static void flush() {
+    qApp->processEvents();
+
+    QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+  }
+
+  static CQPaletteWindow *pageWindow(CQPaletteAreaPage *page) {
+    CQPaletteGroup *group = page->group();
+
+    return (group ? group->window() : nullptr);
+  }
+
+ private:
+  QMainWindow       *window_ { nullptr };
+  CQPaletteAreaMgr  *mgr_    { nullptr };
+  Pages              pages_;
+};
+
+//------
+
+//! timing samples for one named operation
+struct BenchResult {
+  std::string         name;
+  std::vector<double> times; // milliseconds
+
+  double percentile(double p) const {
+    std::vector<double> t = times;
+
+    std::sort(t.begin(), t.end());
+
+    // nearest rank
+    int n = int(t.size());
+    int i = std::max(int(std::ceil(p*n)) - 1, 0);
+
+    return t[std::min(i, n - 1)];
+  }
+
+  double min   () const { return *std::min_element(times.begin(), times.end()); }
+  double median() const { return percentile(0.50); }
+  double p99   () const { return percentile(0.99); }
+};
+
+typedef std::vector<BenchResult> BenchResults;
+
+// run setup/op pair n times and time op only
+BenchResult
+runBench(const std::string &name, int n,
+         const std::function<void (BenchFixture &)> &setup,
+         const std::function<void (BenchFixture &, int)> &op, bool newFixture=false)
+{
+  BenchResult result;
+
+  result.name = name;
+
+  BenchFixture *fixture = nullptr;
+
+  for (int i = 0; i < n; ++i) {
+    if (! fixture || newFixture) {
+      delete fixture;
+
+      fixture = new BenchFixture;
+
+      if (setup)
+        setup(*fixture);
+
+      BenchFixture::flush();
+    }
+
+    QElapsedTimer timer;
+
+    timer.start();
+
+    op(*fixture, i);
+
+    BenchFixture::flush();
+
+    result.times.push_back(timer.nsecsElapsed()/1.0E6);
+  }
+
+  delete fixture;
+
+  return result;
+}
+
+//------
+
+void
+sendMouse(QWidget *w, QEvent::Type type, const QPoint &gpos,
+          Qt::MouseButton button, Qt::MouseButtons buttons)
+{
+  QMouseEvent me(type, w->mapFromGlobal(gpos), gpos, button, buttons, Qt::NoModifier);
+
+  QApplication::sendEvent(w, &me);
+}
+
+// drag window title from its current position to the specified global position
+void
+dragTitle(CQPaletteWindow *window, const QPoint &target)
+{
+  CQPaletteWindowTitle *title = window->findChild<CQPaletteWindowTitle *>();
+  if (! title) return;
+
+  QPoint start = title->mapToGlobal(title->rect().center());
+
+  sendMouse(title, QEvent::MouseButtonPress, start, Qt::LeftButton, Qt::LeftButton);
+
+  const int numSteps = 8;
+
+  for (int i = 1; i <= numSteps; ++i) {
+    QPoint p = start + (target - start)*i/numSteps;
+
+    sendMouse(title, QEvent::MouseMove, p, Qt::NoButton, Qt::LeftButton);
+  }
+
+  sendMouse(title, QEvent::MouseButtonRelease, target, Qt::LeftButton, Qt::NoButton);
+}
+
+//------
+
+BenchResults
+runAll(int n)
+{
+  BenchResults results;
+
+  // add pages to new manager
+  for (int numPages : { 10, 100, 1000 }) {
+    results.push_back(runBench("addPage/" + std::to_string(numPages), n, nullptr,
+      [&](BenchFixture &fixture, int) {
+        fixture.addPages(numPages, Qt::LeftDockWidgetArea);
+      }, /*newFixture*/true));
+  }
+
+  // hide and re-show page
+  results.push_back(runBench("hidePage+showExpandedPage", n,
+    [](BenchFixture &fixture) {
+      fixture.addPages(10, Qt::LeftDockWidgetArea);
+    },
+    [](BenchFixture &fixture, int i) {
+      const BenchFixture::Pages &pages = fixture.pages();
+
+      CQPaletteAreaPage *page = pages[i % pages.size()];
+
+      fixture.mgr()->hidePage(page);
+      fixture.mgr()->showExpandedPage(page);
+    }));
+
+  // dock current page between all four edges
+  results.push_back(runBench("dockAt", n,
+    [](BenchFixture &fixture) {
+      fixture.addPages(4, Qt::LeftDockWidgetArea);
+    },
+    [](BenchFixture &fixture, int i) {
+      CQPaletteWindow *window = BenchFixture::pageWindow(fixture.pages()[0]);
+      if (! window) return;
+
+      window->setCurrentPage(fixture.pages()[0]);
+
+      switch (i % 4) {
+        case 0: window->dockRightSlot (); break;
+        case 1: window->dockTopSlot   (); break;
+        case 2: window->dockBottomSlot(); break;
+        case 3: window->dockLeftSlot  (); break;
+      }
+    }));
+
+  // split current page into new window and join back
+  results.push_back(runBench("split+join", n,
+    [](BenchFixture &fixture) {
+      fixture.addPages(4, Qt::LeftDockWidgetArea);
+    },
+    [](BenchFixture &fixture, int) {
+      CQPaletteAreaPage *page = fixture.pages()[0];
+
+      CQPaletteWindow *window = BenchFixture::pageWindow(page);
+      if (! window) return;
+
+      window->setCurrentPage(page);
+
+      window->splitSlot();
+
+      BenchFixture::flush();
+
+      CQPaletteWindow *newWindow = BenchFixture::pageWindow(page);
+
+      if (newWindow && newWindow != window)
+        newWindow->joinSlot();
+    }));
+
+  // collapse and expand area
+  results.push_back(runBench("collapse+expand", n,
+    [](BenchFixture &fixture) {
+      fixture.addPages(4, Qt::LeftDockWidgetArea);
+    },
+    [](BenchFixture &fixture, int) {
+      CQPaletteWindow *window = BenchFixture::pageWindow(fixture.pages()[0]);
+      if (! window) return;
+
+      CQPaletteArea *area = window->area();
+
+      area->collapseSlot();
+
+      BenchFixture::flush();
+
+      area->expandSlot();
+    }));
+
+  // drag window by title to opposite edge (animateDrop on move, execDrop on release)
+  results.push_back(runBench("titleDrag", n,
+    [](BenchFixture &fixture) {
+      fixture.addPages(2, Qt::LeftDockWidgetArea);
+    },
+    [](BenchFixture &fixture, int i) {
+      CQPaletteWindow *window = BenchFixture::pageWindow(fixture.pages()[0]);
+      if (! window) return;
+
+      QMainWindow *mw = fixture.window();
+
+      int x = ((i & 1) ? 4 : mw->width() - 4);
+
+      dragTitle(window, mw->mapToGlobal(QPoint(x, mw->height()/2)));
+    }));
+
+  return results;
+}
+
+//------
+
+void
+printJSON(const BenchResults &results, int n)
+{
+  std::cout << "{\n";
+  std::cout << "  \"platform\": \"" << QApplication::platformName().toStdString() << "\",\n";
+  std::cout << "  \"iterations\": " << n << ",\n";
+  std::cout << "  \"results\": [\n";
+
+  for (std::size_t i = 0; i < results.size(); ++i) {
+    const BenchResult &result = results[i];
+
+    std::cout << "    { \"name\": \"" << result.name << "\"" <<
+                 ", \"samples\": "   << result.times.size() <<
+                 ", \"min_ms\": "    << result.min() <<
+                 ", \"median_ms\": " << result.median() <<
+                 ", \"p99_ms\": "    << result.p99() << " }" <<
+                 (i + 1 < results.size() ? "," : "") << "\n";
+  }
+
+  std::cout << "  ]\n";
+  std::cout << "}\n";
+}
+
+void
+printCSV(const BenchResults &results)
+{
+  std::cout << "name,samples,min_ms,median_ms,p99_ms\n";
+
+  for (const auto &result : results) {
+    std::cout << result.name << "," << result.times.size() << "," <<
+                 result.min() << "," << result.median() << "," << result.p99() << "\n";
+  }
+}
+
+}
+
+int
+main(int argc, char **argv)
+{
+  if (qgetenv("QT_QPA_PLATFORM").isEmpty())
+    qputenv("QT_QPA_PLATFORM", "offscreen");
+
+  QApplication app(argc, argv);
+
+  bool csv        = false;
+  int  iterations = 20;
+
+  for (int i = 1; i < argc; ++i) {
+    if      (strcmp(argv[i], "-csv") == 0)
+      csv = true;
+    else if (strcmp(argv[i], "-iterations") == 0 && i + 1 < argc)
+      iterations = std::max(atoi(argv[++i]), 1);
+    else {
+      std::cerr << "Usage: CQPaletteAreaBench [-csv] [-iterations <n>]\n";
+      return 1;
+    }
+  }
+
+  BenchResults results = runAll(iterations);
+
+  if (csv)
+    printCSV(results);
+  else
+    printJSON(results, iterations);
+
+  return 0;
+}
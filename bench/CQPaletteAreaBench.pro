@@ -0,0 +1,31 @@
+TEMPLATE = app
+
+TARGET = CQPaletteAreaBench
+
+DEPENDPATH += .
+
+QT += widgets
+
+CONFIG += release
+
+QMAKE_CXXFLAGS += \
+-std=c++17
+
+# Input
+SOURCES += \
+CQPaletteAreaBench.cpp \
+
+DESTDIR     = .
+OBJECTS_DIR = .
+
+INCLUDEPATH += \
+../include \
+../../CQTitleBar/include \
+.
+
+PRE_TARGETDEPS = \
+../lib/libCQPaletteArea.a \
+
+unix:LIBS += \
+-L../lib \
+-lCQPaletteArea
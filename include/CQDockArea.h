@@ -3,9 +3,13 @@
 
 #include <QDockWidget>
 #include <QSize>
+#include <QHash>
+#include <vector>
 
 class QMainWindow;
 class QTimer;
+class QMouseEvent;
+class CQDockAreaEventFilter;
 
 class CQDockArea : public QDockWidget {
   Q_OBJECT
@@ -63,13 +67,17 @@ class CQDockArea : public QDockWidget {
   // handle resize
   void resizeEvent(QResizeEvent *) override;
 
-  bool eventFilter(QObject *obj, QEvent *event) override;
+  //! handle mouse press on splitter handle or floating border (from event filter)
+  void handlePress(QObject *obj, QMouseEvent *me);
 
-  void handleEvent(QObject *obj, QEvent *event);
+  //! handle mouse release (from event filter)
+  void handleRelease();
 
   bool isInsideFloatingBorder(const QPoint &p) const;
 
  protected:
+  friend class CQDockAreaEventFilter;
+
   QMainWindow        *window_;          //! parent main window
   Qt::DockWidgetArea  dockArea_;        //! dock area
   bool                ignoreSize_;      //! ignore resize events
@@ -79,4 +87,38 @@ class CQDockArea : public QDockWidget {
   bool                splitterPressed_; //! splitter pressed
 };
 
+//------
+
+//! single application event filter shared by all dock areas of a main window
+//!
+//! only mouse press/release on registered splitter handles and floating areas
+//! and resize of the main window's central widget are routed to the owning area
+class CQDockAreaEventFilter : public QObject {
+  Q_OBJECT
+
+ public:
+  //! create and install on application
+  CQDockAreaEventFilter(QMainWindow *window, QObject *parent=nullptr);
+
+ ~CQDockAreaEventFilter();
+
+  //! add area and (optional) splitter handle
+  void addArea(CQDockArea *area, QObject *handle=nullptr);
+
+  //! remove area and its splitter handle
+  void removeArea(CQDockArea *area);
+
+ private:
+  bool eventFilter(QObject *obj, QEvent *event) override;
+
+ private:
+  typedef std::vector<CQDockArea *>      Areas;
+  typedef QHash<QObject *, CQDockArea *> Targets;
+
+  QMainWindow *window_    { nullptr }; //! parent main window
+  Areas        areas_;                 //! registered areas
+  Targets      targets_;               //! area for press object (area or handle)
+  CQDockArea  *pressArea_ { nullptr }; //! area with active press
+};
+
 #endif
@@ -2,6 +2,7 @@
 #define CQPaletteArea_H
 
 #include <CQDockArea.h>
+#include <CQSplitterArea.h>
 #include <CQTitleBar.h>
 
 #include <QToolButton>
@@ -22,15 +23,43 @@ class CQPaletteAreaPage;
 class CQSplitterArea;
 class CQWidgetResizer;
 class CQRubberBand;
+class CQDockAreaEventFilter;
+class CQPaletteDragGhost;
+class CQPaletteDropIndicator;
 
 class QScrollArea;
 
+//! title bar button icons
+enum class TitleIcon {
+  None = -1,
+  Pin,
+  Unpin,
+  LeftTriangle,
+  RightTriangle
+};
+
+//! current title bar button icon and tooltip (to skip unchanged updates)
+struct CQTitleButtonState {
+  TitleIcon icon { TitleIcon::None };
+  QString   tip;
+};
+
 //! palette area manager creates palette areas on all four sides of the main
 //! window and controls palette like children which can be moved between each
 //! area
 class CQPaletteAreaMgr : public QObject {
   Q_OBJECT
 
+ public:
+  //! title bar drag mode
+  enum class DragMode {
+    Live, //! float and move the real area/window
+    Ghost //! move translucent snapshot, float real area/window on drop
+  };
+
+ public:
+  typedef std::vector<CQPaletteAreaPage *> Pages;
+
  public:
   //! create dock areas in main window
   CQPaletteAreaMgr(QMainWindow *window);
@@ -41,6 +70,17 @@ class CQPaletteAreaMgr : public QObject {
   //! get main window
   QMainWindow *window() { return window_; }
 
+  //! get shared dock area event filter
+  CQDockAreaEventFilter *dockAreaFilter() const { return dockAreaFilter_; }
+
+  //! get/set title bar drag mode
+  DragMode dragMode() const { return dragMode_; }
+  void setDragMode(DragMode mode) { dragMode_ = mode; }
+
+  //! get/set splitter handle resize mode (for all areas)
+  CQSplitterArea::ResizeMode splitterResizeMode() const { return splitterResizeMode_; }
+  void setSplitterResizeMode(CQSplitterArea::ResizeMode mode);
+
   //! add page to area
   void addPage(CQPaletteAreaPage *page, Qt::DockWidgetArea dockArea);
 
@@ -51,6 +91,105 @@ class CQPaletteAreaMgr : public QObject {
 
   void hidePage(CQPaletteAreaPage *page);
 
+  //! discard widgets of all hidden pages which allow discard (see
+  //! CQPaletteAreaPage::setDiscardTimeout), recreated when shown again
+  void discardHiddenPages();
+
+  //! save layout (areas, windows, page order, current pages and sizes) to binary state
+  QByteArray saveState() const;
+
+  //! restore layout from saveState data in a single batched update, pages are
+  //! matched by name (pages not in state are left in place)
+  //! returns false (and leaves layout unchanged) if state is invalid
+  bool restoreState(const QByteArray &state, const Pages &pages);
+
+  //! apply layout from saveState data with minimal changes to current layout
+  //! (existing windows are reused and only pages in different positions are moved),
+  //! pages are matched by name, returns false if state is invalid
+  bool applyLayout(const QByteArray &state, const Pages &pages);
+
+  //! begin batched update (area splitter, title and size updates deferred to endUpdate)
+  void beginUpdate();
+
+  //! end batched update (single update pass per changed area for outermost call)
+  void endUpdate();
+
+  //! is in batched update
+  bool isUpdating() const { return updateDepth_ > 0; }
+
+  //! batched update guard (begin/end update for scope)
+  class UpdateGuard {
+   public:
+    UpdateGuard(CQPaletteAreaMgr *mgr) : mgr_(mgr) { mgr_->beginUpdate(); }
+   ~UpdateGuard() { mgr_->endUpdate(); }
+
+    UpdateGuard(const UpdateGuard &) = delete;
+    UpdateGuard &operator=(const UpdateGuard &) = delete;
+
+   private:
+    CQPaletteAreaMgr *mgr_ { nullptr };
+  };
+
+  //! invalidate drop target index (area/window geometry or structure changed)
+  void invalidateDropIndex() { dropIndex_.valid = false; }
+
+ private:
+  //! deferred area update flags
+  enum UpdateFlag {
+    UpdateSplitter    = (1<<0), //! updateSplitterSizes
+    UpdateConstraints = (1<<1), //! setSizeConstraints (if expanded)
+    UpdateTitle       = (1<<2), //! updateTitle
+    UpdateSize        = (1<<3), //! updateSize
+    UpdateLayout      = (1<<4), //! updateSplitter (splitter layout)
+    UpdatePreview     = (1<<5)  //! updatePreviewRects (if active)
+  };
+
+  //! pending area updates (in order of first change)
+  typedef std::vector<std::pair<CQPaletteArea *, uint>> PendingUpdates;
+
+  //! cached global drop target geometry of an area
+  struct DropTarget {
+    //! visible splitter child (start/end along dock axis, size clamped to tolerance)
+    struct Child {
+      CQPaletteWindow *window { nullptr };
+      int              start  { 0 };
+      int              end    { 0 };
+      QPoint           pos;
+      QSize            size;
+    };
+
+    typedef std::vector<Child> Children;
+
+    CQPaletteArea *area     { nullptr }; //! target area
+    QRect          rect;                 //! area highlight rect
+    bool           vertical { false };   //! is vertical (left/right) area
+    Children       children;             //! visible splitter children in order
+  };
+
+  //! drop targets for all areas (built on first query of a drag)
+  struct DropIndex {
+    typedef std::vector<DropTarget> Targets;
+
+    bool    valid { false }; //! is valid
+    QRect   windowRect;      //! main window geometry when built
+    Targets targets;         //! targets in area search order
+  };
+
+  //! drop position relative to target window
+  enum class DropSide {
+    Area,   //! add to end of area
+    Before, //! insert before window
+    Merge,  //! merge into window
+    After   //! insert after window
+  };
+
+  //! highlighted drop position (executed on drop)
+  struct DropPos {
+    CQPaletteArea   *area   { nullptr };        //! target area (null if none)
+    CQPaletteWindow *window { nullptr };        //! target window (null for area)
+    DropSide         side   { DropSide::Area }; //! side of target window
+  };
+
  private:
   //! get dock area name
   QString dockAreaName(Qt::DockWidgetArea area) const;
@@ -70,25 +209,88 @@ class CQPaletteAreaMgr : public QObject {
   //! get area at point
   CQPaletteArea *getAreaAt(const QPoint &pos, Qt::DockWidgetAreas allowedAreas) const;
 
+  //! defer area update if in batched update (returns true if deferred)
+  bool deferUpdate(CQPaletteArea *area, uint flags);
+
+  //! schedule area update (run once from event loop, or at end of batched update)
+  void scheduleUpdate(CQPaletteArea *area, uint flags);
+
+  //! add flags to pending area updates
+  void addPendingUpdate(CQPaletteArea *area, uint flags);
+
+  //! remove pending updates of area (deleted)
+  void removePendingUpdates(CQPaletteArea *area);
+
+  //! run pending area updates
+  void flushUpdates();
+
+ private Q_SLOTS:
+  //! run pending area updates (posted)
+  void flushUpdatesSlot();
+
+ private:
+  //! ensure each side has an attached area (drop target)
+  void ensureAttachedAreas();
+
+  //! build drop target index (if invalid or main window geometry changed)
+  void updateDropIndex() const;
+
+  //! get drop target for area
+  const DropTarget *getDropTarget(CQPaletteArea *area) const;
+
+  //! get highlight rect (and optional drop position) of drop target at point
+  QRect getDropTargetRect(const DropTarget &target, const QPoint &pos,
+                          DropPos *dropPos=nullptr) const;
+
   void swapAreas(CQPaletteArea *area1, CQPaletteArea *area2);
 
-  //! highlight area (with rubberband)
+  //! highlight area (with main window overlay or rubberband for detached/floating areas)
   void highlightArea(CQPaletteArea *area, const QPoint &p);
 
-  //! clear highlight
+  //! clear highlight (and highlighted drop position)
   void clearHighlight();
 
+  //! get highlighted drop position
+  const DropPos &dropPos() const { return dropPos_; }
+
+  //! set area/window being ghost dragged (excluded from drop targets, null for none)
+  void setDragSource(QWidget *w);
+
+  //! start ghost drag of area/window
+  void startGhostDrag(QWidget *w);
+
+  //! start ghost drag of single page (page widget and its tab)
+  void startGhostDrag(QWidget *w, QWidget *tabbar, const QRect &tabRect);
+
+  //! move ghost by offset
+  void moveGhostDrag(const QPoint &d);
+
+  //! stop ghost drag
+  void stopGhostDrag();
+
  private:
   friend class CQPaletteArea;
   friend class CQPaletteWindow;
   friend class CQPaletteAreaTitle;
+  friend class CQPaletteWindowTitle;
 
   typedef std::vector<CQPaletteArea *>        Areas;
   typedef std::map<Qt::DockWidgetArea, Areas> Palettes;
 
-  QMainWindow   *window_;     //! parent main window
-  Palettes       palettes_;   //! list of palettes (one per area)
-  CQRubberBand  *rubberBand_; //! rubber band
+  QMainWindow                *window_;             //! parent main window
+  CQDockAreaEventFilter      *dockAreaFilter_;     //! shared event filter for all areas
+  Palettes                    palettes_;           //! list of palettes (one per area)
+  CQRubberBand               *rubberBand_;         //! rubber band (detached/floating targets)
+  CQPaletteDropIndicator     *dropIndicator_;      //! drop highlight overlay (docked targets)
+  mutable DropIndex           dropIndex_;          //! drop target index
+  DropPos                     dropPos_;            //! highlighted drop position
+  QWidget                    *dragSource_;         //! ghost drag source (not a drop target)
+  DragMode                    dragMode_;           //! title bar drag mode
+  CQSplitterArea::ResizeMode  splitterResizeMode_; //! splitter handle resize mode
+  CQPaletteDragGhost         *dragGhost_;          //! ghost drag snapshot (created on demand)
+  int                         updateDepth_;        //! batched update nesting depth
+  PendingUpdates              pendingUpdates_;     //! deferred area updates
+  bool                        updatePosted_;       //! pending update flush posted
 };
 
 //------
@@ -150,6 +352,9 @@ class CQPaletteArea : public CQDockArea {
 
   bool moveSplitter(int d);
 
+  //! clamp splitter move delta to keep dock size in min/max range
+  int clampSplitterDelta(int d) const;
+
   //! size hint
   QSize sizeHint() const override;
 
@@ -183,7 +388,7 @@ class CQPaletteArea : public CQDockArea {
 
   uint numWindows() const { return uint(windows_.size()); }
 
-  uint numVisibleWindows() const;
+  uint numVisibleWindows(const QWidget *exclude=nullptr) const;
 
   bool isFirstWindow(const CQPaletteWindow *window) const;
 
@@ -197,14 +402,18 @@ class CQPaletteArea : public CQDockArea {
   //! update preview state
   void updatePreviewState();
 
-  //! update preview widgets and rects
+  //! update preview widgets and rects (if active)
   void updatePreview();
 
+  //! update preview rects (if active)
+  void updatePreviewRects();
+
   //! add child window
   void addWindow(CQPaletteWindow *window);
 
-  //! add child window at position
-  void addWindowAtPos(CQPaletteWindow *window, const QPoint &gpos);
+  //! add child window at drop position (before/after or merged into target window)
+  void addWindowAt(CQPaletteWindow *window, CQPaletteWindow *target,
+                   CQPaletteAreaMgr::DropSide side);
 
   //! remove child window
   void removeWindow(CQPaletteWindow *window);
@@ -217,6 +426,9 @@ class CQPaletteArea : public CQDockArea {
 
   Qt::DockWidgetAreas calcAllowedAreas() const;
 
+  //! update allowed drop areas at drag start
+  void updateDragAllowedAreas();
+
   //! is floating
   bool isFloating() const { return floating_; }
   //! set floating
@@ -235,14 +447,14 @@ class CQPaletteArea : public CQDockArea {
   //! animate drop at point
   void animateDrop(const QPoint &p);
 
-  //! execute drop at point
+  //! execute drop on highlighted target (detach if none)
   void execDrop(const QPoint &p, bool floating);
 
   //! clear drop animation
   void clearDrop();
 
-  //! get highlight rectangle
-  QRect getHighlightRect() const;
+  //! get highlight rectangle (ignoring excluded window, e.g. drag source)
+  QRect getHighlightRect(const QWidget *exclude=nullptr) const;
 
   //! get/set window state
   WindowState windowState() const { return windowState_; }
@@ -302,6 +514,8 @@ class CQPaletteArea : public CQDockArea {
   bool                  detached_;       //! is detached
   Qt::DockWidgetAreas   allowedAreas_;   //! allowed areas
   CQPalettePreview     *previewHandler_; //! preview (unpinned) handler
+  QList<int>            restoreSizes_;   //! splitter sizes for next splitter update (restore)
+  int                   restoreSize_;    //! dock size for next size update (restore, -1 none)
 };
 
 //------
@@ -376,6 +590,10 @@ class CQPaletteWindow : public QFrame {
 
   void movePage(CQPaletteAreaPage *page, CQPaletteWindow *newWindow);
 
+  //! move pages to other window in one batch (window is not removed if left empty)
+  void movePages(const Pages &pages, CQPaletteWindow *newWindow,
+                 CQPaletteAreaPage *current=nullptr);
+
   CQPaletteAreaPage *currentPage() const;
 
   void setCurrentPage(CQPaletteAreaPage *page);
@@ -448,7 +666,7 @@ class CQPaletteWindow : public QFrame {
   //! animate drop at point
   void animateDrop(const QPoint &p);
 
-  //! execute drop at point
+  //! execute drop on highlighted target (detach if none)
   void execDrop(const QPoint &p, bool floating);
 
   //! clear drop animation
@@ -458,10 +676,15 @@ class CQPaletteWindow : public QFrame {
 
   Qt::DockWidgetAreas calcAllowedAreas() const;
 
+  //! update allowed drop areas at drag start
+  void updateDragAllowedAreas();
+
   void updateTitle();
 
   void resizeEvent(QResizeEvent *) override;
 
+  void moveEvent(QMoveEvent *) override;
+
   void updateDetachSize();
 
  public Q_SLOTS:
@@ -555,6 +778,8 @@ class CQPaletteAreaTitle : public CQTitleBar {
     QPoint pressPos;
     bool   floating;
     bool   dragAll;
+    bool   ghost;
+    QPoint dragPos;
 
     MouseState(){
       reset();
@@ -566,14 +791,17 @@ class CQPaletteAreaTitle : public CQTitleBar {
       escapePress = false;
       floating    = false;
       dragAll     = false;
+      ghost       = false;
     }
   };
 
-  CQPaletteArea    *area_;         //! parent area
-  MouseState        mouseState_;   //! mouse state
-  CQTitleBarButton *pinButton_;    //! pin button
-  CQTitleBarButton *expandButton_; //! expand button
-  QMenu            *contextMenu_;  //! context menu
+  CQPaletteArea      *area_;         //! parent area
+  MouseState          mouseState_;   //! mouse state
+  CQTitleBarButton   *pinButton_;    //! pin button
+  CQTitleBarButton   *expandButton_; //! expand button
+  CQTitleButtonState  pinState_;     //! pin button icon state
+  CQTitleButtonState  expandState_;  //! expand button icon state
+  QMenu              *contextMenu_;  //! context menu
 };
 
 //------
@@ -606,6 +834,9 @@ class CQPaletteWindowTitle : public CQTitleBar {
 
   void updateState();
 
+  //! start ghost drag of window (or only current page and tab if split off)
+  void startGhostDrag();
+
   void contextMenuEvent(QContextMenuEvent *e) override;
 
   //! handle mouse events
@@ -628,6 +859,8 @@ class CQPaletteWindowTitle : public CQTitleBar {
     QPoint pressPos;
     bool   floating;
     bool   dragAll;
+    bool   ghost;
+    QPoint dragPos;
 
     MouseState(){
       reset();
@@ -639,15 +872,18 @@ class CQPaletteWindowTitle : public CQTitleBar {
       escapePress = false;
       floating    = false;
       dragAll     = false;
+      ghost       = false;
     }
   };
 
-  CQPaletteWindow  *window_;       //! parent window
-  MouseState        mouseState_;   //! mouse state
-  CQTitleBarButton *pinButton_;    //! pin button
-  CQTitleBarButton *expandButton_; //! expand button
-  CQTitleBarButton *closeButton_;  //! close button
-  QMenu            *contextMenu_;  //! context menu
+  CQPaletteWindow    *window_;       //! parent window
+  MouseState          mouseState_;   //! mouse state
+  CQTitleBarButton   *pinButton_;    //! pin button
+  CQTitleBarButton   *expandButton_; //! expand button
+  CQTitleBarButton   *closeButton_;  //! close button
+  CQTitleButtonState  pinState_;     //! pin button icon state
+  CQTitleButtonState  expandState_;  //! expand button icon state
+  QMenu              *contextMenu_;  //! context menu
 };
 
 #endif
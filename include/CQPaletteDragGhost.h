@@ -0,0 +1,39 @@
+#ifndef CQPaletteDragGhost_H
+#define CQPaletteDragGhost_H
+
+#include <QWidget>
+#include <QPixmap>
+
+//! translucent top level snapshot of a palette area/window shown while it
+//! is dragged (the live widget is only reparented when the drag ends)
+class CQPaletteDragGhost : public QWidget {
+  Q_OBJECT
+
+ public:
+  CQPaletteDragGhost();
+
+  //! get/set opacity
+  double opacity() const { return opacity_; }
+  void setOpacity(double opacity) { opacity_ = opacity; }
+
+  //! start drag of widget (snapshot at its current global position)
+  void start(QWidget *w);
+
+  //! start drag of widget and tab (rect in tab bar) combined at global positions
+  void start(QWidget *w, QWidget *tabbar, const QRect &tabRect);
+
+  //! move by offset
+  void moveBy(const QPoint &d);
+
+  //! end drag
+  void stop();
+
+ private:
+  void paintEvent(QPaintEvent *) override;
+
+ private:
+  QPixmap pixmap_;           //! widget snapshot
+  double  opacity_ { 0.6 };  //! draw opacity
+};
+
+#endif
@@ -0,0 +1,41 @@
+#ifndef CQPaletteDropIndicator_H
+#define CQPaletteDropIndicator_H
+
+#include <QWidget>
+#include <QBrush>
+
+//! drop target highlight drawn as a (non-native) child overlay of the main
+//! window, so moving it only repaints the old and new rects
+class CQPaletteDropIndicator : public QWidget {
+  Q_OBJECT
+
+ public:
+  CQPaletteDropIndicator(QWidget *parent);
+
+  //! get/set border color
+  const QColor &color() const { return color_; }
+  void setColor(const QColor &c) { color_ = c; update(); }
+
+  //! get/set draw inner border (off for thin lines)
+  bool isInnerBorder() const { return innerBorder_; }
+  void setInnerBorder(bool b) { innerBorder_ = b; update(); }
+
+  //! show at global rect
+  void setGlobalRect(const QRect &rect);
+
+ private:
+  void paintEvent(QPaintEvent *) override;
+
+  void changeEvent(QEvent *e) override;
+
+  //! get fill brush (cached pattern pixmap)
+  const QBrush &fillBrush();
+
+ private:
+  QColor color_       { 255, 0, 0 }; //! border color
+  bool   innerBorder_ { true };        //! draw inner border
+  QBrush brush_;                      //! cached fill brush
+  bool   brushValid_  { false };      //! is fill brush valid
+};
+
+#endif
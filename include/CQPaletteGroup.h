@@ -5,6 +5,9 @@
 
 #include <QStackedWidget>
 #include <QIcon>
+#include <QVariant>
+#include <QHash>
+#include <functional>
 #include <map>
 
 class CQPaletteGroup;
@@ -13,6 +16,8 @@ class CQPaletteGroupTabBar;
 class CQPaletteGroupStack;
 class CQPaletteAreaPage;
 
+class QTimer;
+
 #define CQPaletteGroupMgrInst CQPaletteGroupMgr::getInstance()
 
 class CQPaletteGroupMgr {
@@ -25,15 +30,18 @@ class CQPaletteGroupMgr {
 
   CQPaletteGroup *getGroup(const QString &name) const;
 
-  CQPaletteGroup *getGroupFromTabBar(const QString &name) const;
+  //! get group from unique tab bar id (see CQTabBar::id)
+  CQPaletteGroup *getGroupFromTabBarId(uint id) const;
 
  private:
   CQPaletteGroupMgr();
 
  private:
   typedef std::vector<CQPaletteGroup *> Groups;
+  typedef QHash<uint, CQPaletteGroup *> TabBarGroups;
 
-  Groups groups_;
+  Groups       groups_;       // groups (in creation order)
+  TabBarGroups tabBarGroups_; // group for tab bar id
 };
 
 // class to hold a tabbed set of widgets displayed in a palette sub window
@@ -68,20 +76,39 @@ class CQPaletteGroup : public QWidget {
 
   void removePage(CQPaletteAreaPage *page);
 
+  //! add page as hidden (no tab and never current)
+  void addHiddenPage(CQPaletteAreaPage *page);
+
   void showPage(CQPaletteAreaPage *page);
 
   void hidePage(CQPaletteAreaPage *page);
 
+  //! move pages (visible and hidden) to other group in one batch (single tab bar
+  //! relayout and current page change per group), current is new group's current page
+  void movePages(const PageArray &pages, CQPaletteGroup *newGroup,
+                 CQPaletteAreaPage *current=nullptr);
+
   CQPaletteAreaPage *currentPage() const;
 
   int currentIndex() const;
 
   void setCurrentPage(CQPaletteAreaPage *page);
 
+  //! get visible page at tab position
   CQPaletteAreaPage *getPage(int i) const;
 
+  //! get visible pages (in tab order)
   void getPages(PageArray &pages) const;
 
+  //! get tab position of visible page (-1 if hidden or not in group)
+  int pageIndex(CQPaletteAreaPage *page) const;
+
+  //! get all pages (visible pages in tab order then hidden pages)
+  void getAllPages(PageArray &pages) const;
+
+  //! discard widgets of hidden pages (which allow discard)
+  void discardHiddenPages();
+
   QSize sizeHint() const override;
 
  signals:
@@ -92,26 +119,49 @@ class CQPaletteGroup : public QWidget {
 
   void pressTabIndex(int ind);
 
-  void tabMovePageSlot(const QString &fromName, int fromIndex, const QString &toName, int toIndex);
+  void tabMovePageSlot(uint fromTabBarId, int fromIndex, uint toTabBarId, int toIndex);
+
+  void tabMovedSlot(int fromIndex, int toIndex);
 
  private:
   void updateCurrentPage();
 
+  //! add visible page at tab position with tab index
+  void addVisiblePage(int pos, CQPaletteAreaPage *page, int ind);
+
+  //! remove visible page (and its tab)
+  void removeVisiblePage(CQPaletteAreaPage *page);
+
+  //! update visible page positions from tab position
+  void updatePagePos(int pos);
+
+  //! rebuild visible pages from tab bar order
+  void updateVisiblePages();
+
   void updateLayout();
 
   CQPaletteAreaPage *getPageForIndex(int ind) const;
 
+  //! invalidate page size caches on stack layout request
+  bool eventFilter(QObject *obj, QEvent *e) override;
+
   void showEvent(QShowEvent *) override;
 
   void resizeEvent(QResizeEvent *) override;
 
  private:
-  typedef std::map<uint, CQPaletteAreaPage*> Pages;
+  typedef std::map<uint, CQPaletteAreaPage*>  Pages;
+  typedef QHash<uint, int>                    PageInds;
+  typedef QHash<int, CQPaletteAreaPage *>     TabPages;
 
   CQPaletteWindow      *window_;
   CQPaletteGroupTabBar *tabbar_;
   CQPaletteGroupStack  *stack_;
-  Pages                 pages_;
+  Pages                 pages_;        // all pages (by id)
+  PageArray             visiblePages_; // visible pages (in tab order)
+  PageInds              pagePos_;      // visible page id to tab position
+  PageInds              pageTabs_;     // visible page id to tab index
+  TabPages              tabPages_;     // tab index to visible page
 };
 
 //------
@@ -125,11 +175,11 @@ class CQPaletteGroupTabBar : public CQTabBar {
 
   void updateDockArea();
 
-  void addPage(CQPaletteAreaPage *page);
+  //! add tab for page (returns tab index)
+  int addPage(CQPaletteAreaPage *page);
 
-  void insertPage(int ind, CQPaletteAreaPage *page);
-
-  void removePage(CQPaletteAreaPage *page);
+  //! insert tab for page at position (returns tab index)
+  int insertPage(int ind, CQPaletteAreaPage *page);
 
   uint getPageId(int ind) const;
 
@@ -163,17 +213,34 @@ class CQPaletteGroupStack : public QStackedWidget {
 class CQPaletteAreaPage : public QObject {
   Q_OBJECT
 
+ public:
+  //! function to create page widget on first use
+  typedef std::function<QWidget *()> WidgetFactory;
+
  public:
   CQPaletteAreaPage(QWidget *w=nullptr);
 
+  //! create page with widget created on first activation
+  CQPaletteAreaPage(const WidgetFactory &factory);
+
   virtual ~CQPaletteAreaPage() { }
 
   CQPaletteGroup *group() const { return group_; }
   virtual void setGroup(CQPaletteGroup *group) { group_ = group; }
 
+  //! get widget (null if not created yet)
   QWidget *widget() const { return w_; }
   virtual void setWidget(QWidget *w);
 
+  //! get widget (create if needed)
+  QWidget *ensureWidget();
+
+  //! is widget created
+  bool hasWidget() const { return w_ != nullptr; }
+
+  //! size used for min size until widget is created
+  virtual QSize placeholderSize() const { return QSize(100, 100); }
+
   uint id() const { return id_; }
 
   Qt::DockWidgetArea dockArea() const { return dockArea_; }
@@ -183,10 +250,12 @@ class CQPaletteAreaPage : public QObject {
   virtual void setHidden(bool hidden) { hidden_ = hidden; }
 
   bool widthResizable() const { return widthResizable_; }
-  virtual void setWidthResizable(bool resizable) { widthResizable_ = resizable; }
+  virtual void setWidthResizable(bool resizable) {
+    widthResizable_ = resizable; invalidateSizeCache(); }
 
   bool heightResizable() const { return heightResizable_; }
-  virtual void setHeightResizable(bool resizable) { heightResizable_ = resizable; }
+  virtual void setHeightResizable(bool resizable) {
+    heightResizable_ = resizable; invalidateSizeCache(); }
 
   virtual void setFixedWidth (int width ) { fixedWidth_  = width ; setWidthResizable (false); }
   virtual void setFixedHeight(int height) { fixedHeight_ = height; setHeightResizable(false); }
@@ -196,16 +265,62 @@ class CQPaletteAreaPage : public QObject {
   virtual QString title() const { return ""; }
   virtual QIcon   icon () const { return QIcon(); }
 
+  //! unique name to identify page in saved layout (default is title)
+  virtual QString name() const { return title(); }
+
   virtual Qt::DockWidgetAreas allowedAreas() const { return Qt::AllDockWidgetAreas; }
 
   void getMinMaxWidth (int &min_w, int &max_w) const;
   void getMinMaxHeight(int &min_h, int &max_h) const;
 
+  //! invalidate cached widget min/max size (automatic on widget or group stack layout request)
+  void invalidateSizeCache() { sizeValid_ = false; }
+
+  //! get/set seconds page can be hidden before its widget is discarded
+  //! (-1 never discard, 0 only discard on CQPaletteAreaMgr::discardHiddenPages)
+  //! page must be able to recreate widget (see canRecreateWidget)
+  int discardTimeout() const { return discardTimeout_; }
+  void setDiscardTimeout(int secs);
+
+  //! can widget be discarded when hidden (discard enabled and widget can be recreated)
+  bool isDiscardable() const { return discardTimeout_ >= 0 && canRecreateWidget(); }
+
+  //! can widget be recreated after discard (default is if factory set)
+  //! subclasses overriding createWidget should return true
+  virtual bool canRecreateWidget() const { return bool(factory_); }
+
+  //! discard widget (if hidden and discardable), state is saved for recreate
+  bool discardWidget();
+
+  //! start/stop discard timer (on hide/show)
+  void startDiscardTimer();
+  void stopDiscardTimer();
+
+ protected:
+  //! create widget on first activation (default uses factory)
+  virtual QWidget *createWidget();
+
+  //! save widget state before discard
+  virtual QVariant saveState() const { return QVariant(); }
+
+  //! restore widget state after recreate
+  virtual void restoreState(const QVariant &) { }
+
+  bool eventFilter(QObject *obj, QEvent *e) override;
+
+ private:
+  //! update cached widget min/max size
+  void updateSizeCache() const;
+
+ private Q_SLOTS:
+  void discardTimerSlot();
+
  private:
   static uint lastId_;
 
   CQPaletteGroup     *group_;           // parent group
   QWidget            *w_;               // child widget
+  WidgetFactory       factory_;         // child widget factory
   uint                id_;              // unique id
   Qt::DockWidgetArea  dockArea_;        // dock area
   bool                hidden_;          // hidden
@@ -213,6 +328,12 @@ class CQPaletteAreaPage : public QObject {
   int                 fixedHeight_;     // fixed height
   bool                widthResizable_;  // resizable
   bool                heightResizable_; // resizable
+  mutable bool        sizeValid_;       // cached min/max size valid
+  mutable QSize       minSize_;         // cached widget min size
+  mutable QSize       maxSize_;         // cached widget max size
+  int                 discardTimeout_;  // hidden seconds before discard
+  QTimer             *discardTimer_;    // discard timer
+  QVariant            savedState_;      // state of discarded widget
 };
 
 #endif
@@ -3,14 +3,18 @@
 
 #include <QWidget>
 #include <QSet>
+#include <vector>
 
 class CQPaletteArea;
+class CQPalettePreviewFilter;
+class QMouseEvent;
 
 class CQPalettePreview : public QObject {
   Q_OBJECT
 
  public:
   CQPalettePreview();
+ ~CQPalettePreview();
 
   bool active() const { return active_; }
 
@@ -20,15 +24,22 @@ class CQPalettePreview : public QObject {
 
   void addRect(const QRect &r);
 
+  //! clear widgets and rects
   void clear();
 
+  //! clear widgets (and their children marked as members)
+  void clearWidgets();
+
+  //! clear rects
+  void clearRects();
+
  signals:
   void stopPreview();
 
  private:
-  bool eventFilter(QObject *obj, QEvent *event) override;
+  friend class CQPalettePreviewFilter;
 
-  bool processEvent(QObject *obj, QEvent *event);
+  bool processEvent(QWidget *w, QMouseEvent *me);
 
   bool isPreviewValid() const;
 
@@ -38,16 +49,23 @@ class CQPalettePreview : public QObject {
 
   bool isPreviewWidget(QWidget *w) const;
 
+  //! mark widget as member (removed when destroyed)
+  void addMember(QWidget *w) const;
+
   bool isModalDialogWidget(QWidget *w) const;
 
- private:
-  typedef QSet<QWidget *> Widgets;
-  typedef QList<QRect>    Rects;
+ private Q_SLOTS:
+  void widgetDestroyedSlot(QObject *obj);
 
-  bool    active_;
-  bool    stopOnRelease_;
-  Widgets widgets_;
-  Rects   rects_;
+ private:
+  typedef QSet<QObject *>    Widgets;
+  typedef std::vector<QRect> Rects;
+
+  bool            active_;
+  bool            stopOnRelease_;
+  Widgets         widgets_; // preview widgets (removed on destroy)
+  mutable Widgets members_; // preview widgets and their children (removed on destroy)
+  Rects           rects_;   // global preview rects (updated on move/resize)
 };
 
 #endif
@@ -2,11 +2,14 @@
 #define CQSplitterArea_H
 
 #include <QWidget>
+#include <QPointer>
 
 class QMainWindow;
 class CQPaletteArea;
 class QSplitter;
+class QTimer;
 class CQSplitterHandle;
+class CQPaletteDropIndicator;
 
 class CQSplitterArea : public QWidget {
   Q_OBJECT
@@ -15,6 +18,14 @@ class CQSplitterArea : public QWidget {
   Q_PROPERTY(bool               resizable READ isResizable)
   Q_PROPERTY(bool               floating  READ isFloating)
 
+ public:
+  //! handle drag resize mode
+  enum class ResizeMode {
+    Immediate,  //! resize on every mouse move
+    FramePaced, //! accumulate mouse moves and resize at most once per frame
+    Guide       //! draw guide line and resize on release
+  };
+
  public:
   CQSplitterArea(CQPaletteArea *palette);
 
@@ -33,20 +44,27 @@ class CQSplitterArea : public QWidget {
   bool isFloating() const { return floating_; }
   void setFloating(bool floating);
 
+  //! get/set handle drag resize mode
+  ResizeMode resizeMode() const { return resizeMode_; }
+  void setResizeMode(ResizeMode mode) { resizeMode_ = mode; }
+
   QSplitter *splitter() { return splitter_; }
 
+  CQSplitterHandle *handle() const { return handle_; }
+
   void updateLayout();
 
  private:
   void showEvent(QShowEvent *) override;
 
  private:
-  CQPaletteArea      *palette_   { nullptr };
-  Qt::DockWidgetArea  dockArea_  { Qt::LeftDockWidgetArea };
-  bool                resizable_ { true };
-  bool                floating_  { false };
-  QSplitter          *splitter_  { nullptr };
-  CQSplitterHandle   *handle_    { nullptr };
+  CQPaletteArea      *palette_    { nullptr };
+  Qt::DockWidgetArea  dockArea_   { Qt::LeftDockWidgetArea };
+  bool                resizable_  { true };
+  bool                floating_   { false };
+  ResizeMode          resizeMode_ { ResizeMode::Immediate };
+  QSplitter          *splitter_   { nullptr };
+  CQSplitterHandle   *handle_     { nullptr };
 };
 
 class CQSplitterHandle : public QWidget {
@@ -55,6 +73,8 @@ class CQSplitterHandle : public QWidget {
  public:
   CQSplitterHandle(CQSplitterArea *area);
 
+ ~CQSplitterHandle();
+
   CQSplitterArea *area() { return area_; }
 
  private:
@@ -71,6 +91,19 @@ class CQSplitterHandle : public QWidget {
 
   void paintEvent(QPaintEvent *) override;
 
+  //! get move delta (along resize direction) from press position
+  int moveDelta(const QPoint &gpos) const;
+
+  //! resize palette for mouse position
+  void applyMove(const QPoint &gpos);
+
+  //! show guide line for mouse position
+  void updateGuide(const QPoint &gpos);
+
+ private Q_SLOTS:
+  //! apply accumulated move (frame paced mode)
+  void moveTimerSlot();
+
  private:
   struct MouseState {
     bool   pressed;
@@ -81,9 +114,14 @@ class CQSplitterHandle : public QWidget {
     }
   };
 
-  CQSplitterArea *area_      { nullptr };
-  MouseState      mouseState_;
-  bool            mouseOver_ { false };
+  CQSplitterArea                   *area_        { nullptr };
+  MouseState                        mouseState_;
+  bool                              mouseOver_   { false };
+  QTimer                           *moveTimer_   { nullptr }; //! frame paced move timer
+  QPoint                            movePos_;                 //! pending move position (frame paced)
+  bool                              movePending_ { false };   //! move pending (frame paced)
+  QPointer<CQPaletteDropIndicator>  guide_;                   //! resize guide line (child overlay)
+  int                               guideDelta_  { 0 };       //! clamped guide delta
 };
 
 #endif
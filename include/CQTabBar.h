@@ -5,8 +5,13 @@
 #include <QToolButton>
 #include <QIcon>
 #include <QVariant>
+#include <QPixmap>
+
+#include <unordered_map>
+#include <vector>
 
 class QMimeData;
+class QStyleOptionTab;
 
 class CQTabBarButton;
 class CQTabBarScrollButton;
@@ -27,6 +32,7 @@ class CQTabBar : public QWidget {
   Q_PROPERTY(QSize               iconSize     READ iconSize     WRITE setIconSize)
   Q_PROPERTY(bool                flowTabs     READ isFlowTabs   WRITE setFlowTabs)
   Q_PROPERTY(QColor              pendingColor READ pendingColor WRITE setPendingColor)
+  Q_PROPERTY(bool                pixmapCache  READ isPixmapCache WRITE setPixmapCache)
 
   Q_ENUMS(Position)
 
@@ -52,6 +58,11 @@ class CQTabBar : public QWidget {
 
   //---
 
+  //! get unique tab bar id (identifies source tab bar in drag data)
+  uint id() const { return id_; }
+
+  //---
+
   //! get tab position (relative to contents)
   Position position() const { return position_; }
   //! set tab position (relative to contents)
@@ -71,17 +82,25 @@ class CQTabBar : public QWidget {
 
   //! get/set flow tabs
   bool isFlowTabs() const { return flowTabs_; }
-  void setFlowTabs(bool b) { flowTabs_ = b; }
+  void setFlowTabs(bool b) { flowTabs_ = b; updateSizes(); update(); }
 
   //! get/set pending color
   const QColor &pendingColor() const { return pendingColor_; }
   void setPendingColor(const QColor &c) { pendingColor_ = c; update(); }
 
+  //! get/set use cached tab pixmaps for drawing
+  bool isPixmapCache() const { return pixmapCache_; }
+  void setPixmapCache(bool b);
+
   //---
 
   //! clear tabs
   void clear();
 
+  //! begin/end batched tab changes (tab sizes updated once on outermost end)
+  void beginUpdate();
+  void endUpdate();
+
   //! add tab for specified text and widget
   int addTab(const QString &text, QWidget *widget=nullptr);
   //! add tab for specified text, icon and widget
@@ -153,6 +172,9 @@ class CQTabBar : public QWidget {
   //! get index of tab at specified point
   int tabAt(const QPoint &p) const;
 
+  //! get rectangle of tab (empty if not visible)
+  QRect tabRect(int ind) const;
+
   //! update sizes of tabs
   void updateSizes();
 
@@ -165,12 +187,24 @@ class CQTabBar : public QWidget {
   //! get tab button array pos
   int tabButtonPos(int index) const;
 
+  //! update tab index to array pos map from array pos
+  void updateTabPos(int pos);
+
   //! handle paint event
   void paintEvent(QPaintEvent *) override;
 
   //! handle resize event
   void resizeEvent(QResizeEvent *) override;
 
+  //! handle change event
+  void changeEvent(QEvent *e) override;
+
+  //! mark cached tab geometry as invalid
+  void invalidateLayout();
+
+  //! update cached tab geometry (if invalid)
+  void updateLayout() const;
+
   //! handle mouse press event
   void mousePressEvent(QMouseEvent *) override;
 
@@ -180,20 +214,26 @@ class CQTabBar : public QWidget {
   //! handle mouse release event
   void mouseReleaseEvent(QMouseEvent *) override;
 
+  //! handle mouse leave event
+  void leaveEvent(QEvent *) override;
+
   //! handle drag enter
   void dragEnterEvent(QDragEnterEvent *event) override;
 
   //! handle drag move
   void dragMoveEvent(QDragMoveEvent *event) override;
 
+  //! handle drag leave
+  void dragLeaveEvent(QDragLeaveEvent *event) override;
+
   //! handle drop
   void dropEvent(QDropEvent *event) override;
 
-  //! check if drag valid
-  bool dragValid(const QMimeData *m, QString &type, int &tabNum) const;
+  //! check if drag valid (parse source tab bar id and tab index from drag data)
+  bool dragValid(const QMimeData *m, uint &tabBarId, int &tabNum) const;
 
   //! drag pos valid
-  bool dragPosValid(const QString &type, const QPoint &pos) const;
+  bool dragPosValid(uint tabBarId, const QPoint &pos) const;
 
   //! handle context menu event
   void contextMenuEvent(QContextMenuEvent *e) override;
@@ -218,6 +258,21 @@ class CQTabBar : public QWidget {
   //! set press state
   void setPressPoint(const QPoint &p);
 
+  //! set tab under mouse
+  void setMoveIndex(int ind);
+
+  //! redraw single tab
+  void updateTab(int ind);
+
+  //! get redraw rectangle for tab
+  QRect tabUpdateRect(CQTabBarButton *button) const;
+
+  //! draw tab using cached pixmap (render pixmap if out of date)
+  void drawCachedTab(QPainter *painter, CQTabBarButton *button, const QStyleOptionTab &opt);
+
+  //! release cached tab pixmaps (rendered again on next draw)
+  void clearTabPixmaps();
+
  Q_SIGNALS:
   //! signal that the current tab has changed
   void currentChanged(int index);
@@ -235,7 +290,7 @@ class CQTabBar : public QWidget {
   void tabMoved(int, int);
 
   //! request page move (to another palette group)
-  void tabMovePageSignal(const QString &, int, const QString &, int);
+  void tabMovePageSignal(uint fromTabBarId, int fromIndex, uint toTabBarId, int toIndex);
 
  private Q_SLOTS:
   //! handle left/bottom scroll button press
@@ -245,8 +300,19 @@ class CQTabBar : public QWidget {
 
  private:
   using TabButtons = std::vector<CQTabBarButton *>;
+  using TabPos     = std::unordered_map<int, int>;
 
-  TabButtons buttons_;             //!< tab page buttons
+  //! drag data (parsed once on drag enter)
+  struct DragData {
+    bool valid    { false }; //!< is valid tab drag
+    uint tabBarId { 0 };     //!< source tab bar id
+    int  tabIndex { -1 };    //!< source tab index
+  };
+
+  uint       id_;                  //!< unique tab bar id
+  TabButtons buttons_;             //!< tab page buttons (dense, in display order)
+  TabPos     tabPos_;              //!< tab index to buttons_ array pos
+  int        nextIndex_    { 0 };  //!< next tab index
   int        currentIndex_ { -1 }; //!< current tab index (-1 if none)
 
   Position position_   { Position::North }; //!< tab position (relative to contents)
@@ -256,6 +322,8 @@ class CQTabBar : public QWidget {
 
   QColor pendingColor_ { Qt::red };
 
+  bool pixmapCache_ { false }; //!< use cached tab pixmaps for drawing
+
   Qt::ToolButtonStyle buttonStyle_ { Qt::ToolButtonIconOnly };
                                    //!< tab button style (text and/or icon)
 
@@ -264,6 +332,10 @@ class CQTabBar : public QWidget {
   CQTabBarScrollButton *lscroll_ { nullptr }; //!< left/bottom scroll button if clipped
   CQTabBarScrollButton *rscroll_ { nullptr }; //!< right/top scroll button if clipped
 
+  mutable bool   layoutValid_   { false }; //!< is cached tab geometry valid
+  mutable int    hintWidth_     { 0 };     //!< size hint width (sum of tab widths)
+  mutable int    firstIndex_    { -1 };    //!< first visible tab index
+  mutable int    lastIndex_     { -1 };    //!< last visible tab index (-1 if only one)
   mutable int    iw_            { 0 };     //!< tab bar icon width
   mutable int    w_             { 0 };     //!< tab bar width
   mutable int    h_             { 0 };     //!< tab bar height
@@ -274,6 +346,9 @@ class CQTabBar : public QWidget {
   mutable QPoint pressPos_;                //!< button press pos (for drag)
   mutable int    pressIndex_    { -1 };    //!< tab at press position
   mutable int    moveIndex_     { -1 };    //!< tab at current mouse position
+  DragData       dragData_;                //!< current drag data (from drag enter)
+  int            updateDepth_   { 0 };     //!< batched update depth
+  bool           sizesPending_  { false }; //!< sizes update pending (batched update)
 };
 
 //---
@@ -284,6 +359,30 @@ class CQTabBarButton {
  private:
   enum { TAB_BORDER=8 };
 
+ public:
+  //! key for rendered tab pixmap (pixmap reused while unchanged)
+  struct PixmapKey {
+    QString text;
+    qint64  iconKey    { 0 };
+    int     shape      { 0 };
+    int     state      { 0 };
+    int     position   { 0 };
+    qint64  paletteKey { 0 };
+    QRgb    pendingRgb { 0 };
+    QSize   size;
+    qreal   dpr        { 1.0 };
+
+    bool operator==(const PixmapKey &rhs) const {
+      return (iconKey  == rhs.iconKey  && shape      == rhs.shape      &&
+              state    == rhs.state    && position   == rhs.position   &&
+              size     == rhs.size     && paletteKey == rhs.paletteKey &&
+              dpr      == rhs.dpr      && pendingRgb == rhs.pendingRgb &&
+              text     == rhs.text);
+    }
+
+    bool operator!=(const PixmapKey &rhs) const { return ! operator==(rhs); }
+  };
+
  public:
   CQTabBarButton(CQTabBar *bar);
 
@@ -338,10 +437,18 @@ class CQTabBarButton {
   //! get pixmap of icon
   QPixmap pixmap() const;
 
-  //! calc button width, height
+  //! get/set rendered tab pixmap and its key
+  const PixmapKey &tabPixmapKey() const { return tabPixmapKey_; }
+  const QPixmap &tabPixmap() const { return tabPixmap_; }
+  void setTabPixmap(const PixmapKey &key, const QPixmap &pixmap);
+
+  //! calc button width, height (cached)
   int width () const;
   int height() const;
 
+  //! invalidate cached width, height (font change)
+  void invalidateSize();
+
  private:
   using Position = CQTabBar::Position;
 
@@ -353,12 +460,22 @@ class CQTabBarButton {
 
   mutable QIcon    positionIcon_;                     //! icon for position (cached)
   mutable Position iconPosition_ { Position::North }; //! position used for above (cached)
+  mutable qreal    iconDpr_      { 0.0 };             //! pixel ratio used for above (cached)
+
+  mutable int                 width_         { -1 }; //! width (cached, -1 if invalid)
+  mutable int                 height_        { -1 }; //! height (cached, -1 if invalid)
+  mutable Qt::ToolButtonStyle sizeStyle_     { Qt::ToolButtonIconOnly };
+                                                     //! button style used for above
+  mutable int                 sizeIconWidth_ { 0 };  //! icon width used for above
 
   QString  toolTip_;             //! tooltip
   QWidget* w_       { nullptr }; //! associated widget
   bool     visible_ { true };    //! is visible
   bool     pending_ { false };   //! is pending
   QRect    r_;                   //! bounding box
+
+  PixmapKey tabPixmapKey_; //! key for rendered tab pixmap
+  QPixmap   tabPixmap_;    //! rendered tab pixmap (if pixmap cache enabled)
 };
 
 //---
@@ -1,12 +1,11 @@
 #include <CQDockArea.h>
-#include <CQSplitterArea.h>
-#include <CQPaletteArea.h>
 
 #include <QApplication>
 #include <QMainWindow>
 #include <QTimer>
 #include <QMouseEvent>
 
+#include <algorithm>
 #include <iostream>
 
 enum { EXTRA_FLOAT_WIDTH  = 8 };
@@ -21,8 +20,6 @@ CQDockArea(QMainWindow *window) :
   setObjectName("dockArea");
 
   setFocusPolicy(Qt::NoFocus);
-
-  qApp->installEventFilter(this);
 }
 
 // get whether on vertical dock area (left or right)
@@ -170,63 +167,123 @@ resizeEvent(QResizeEvent *)
 //------
 
 // handle mouse press events on splitter and detached border
-bool
+void
 CQDockArea::
-eventFilter(QObject *obj, QEvent *event)
+handlePress(QObject *obj, QMouseEvent *me)
 {
-  handleEvent(obj, event);
+  if (! isVisible()) return;
 
-  return QObject::eventFilter(obj, event);
+  if (! isFloating()) {
+    // press on our splitter handle
+    if (obj != this)
+      splitterPressed_ = true;
+  }
+  else {
+    if (obj != this) return;
+
+    if (isInsideFloatingBorder(me->pos()))
+      splitterPressed_ = true;
+  }
 }
 
 void
 CQDockArea::
-handleEvent(QObject *obj, QEvent *event)
+handleRelease()
 {
-  QEvent::Type type = event->type();
+  if (splitterPressed_)
+    splitterPressed_ = false;
+}
 
-  if      (type == QEvent::MouseButtonPress) {
-    if (! isVisible()) return;
+//------
 
-    QMouseEvent *me = static_cast<QMouseEvent *>(event);
+bool
+CQDockArea::
+isInsideFloatingBorder(const QPoint &p) const
+{
+  QRect r = childrenRect();
 
-    if (! isFloating()) {
-      CQSplitterHandle *handle = qobject_cast<CQSplitterHandle *>(obj);
+  return (p.x() < r.left () || p.y() < r.top   () ||
+          p.x() > r.right() || p.y() > r.bottom());
+}
 
-      if (! handle) return;
+//------
 
-      CQPaletteArea *palette = handle->area()->palette();
+CQDockAreaEventFilter::
+CQDockAreaEventFilter(QMainWindow *window, QObject *parent) :
+ QObject(parent), window_(window)
+{
+  setObjectName("dockAreaFilter");
 
-      if (palette == this)
-        splitterPressed_ = true;
-    }
-    else {
-      if (qobject_cast<CQDockArea *>(obj) != this) return;
+  qApp->installEventFilter(this);
+}
 
-      if (isInsideFloatingBorder(me->pos()))
-        splitterPressed_ = true;
-    }
-  }
-  else if (type == QEvent::MouseButtonRelease) {
-    if (splitterPressed_)
-      splitterPressed_ = false;
-  }
-  else if (type == QEvent::Resize) {
-    QWidget *mw = window_->centralWidget();
+CQDockAreaEventFilter::
+~CQDockAreaEventFilter()
+{
+  qApp->removeEventFilter(this);
+}
 
-    if (mw == obj)
-      emit centralWidgetResized();
-  }
+void
+CQDockAreaEventFilter::
+addArea(CQDockArea *area, QObject *handle)
+{
+  areas_.push_back(area);
+
+  targets_[area] = area;
+
+  if (handle)
+    targets_[handle] = area;
 }
 
-//------
+void
+CQDockAreaEventFilter::
+removeArea(CQDockArea *area)
+{
+  auto p = std::find(areas_.begin(), areas_.end(), area);
+
+  if (p != areas_.end())
+    areas_.erase(p);
 
+  for (auto pt = targets_.begin(); pt != targets_.end(); ) {
+    if (pt.value() == area)
+      pt = targets_.erase(pt);
+    else
+      ++pt;
+  }
+
+  if (pressArea_ == area)
+    pressArea_ = nullptr;
+}
+
+// route press on splitter handle/floating border and central widget resize to owning area
 bool
-CQDockArea::
-isInsideFloatingBorder(const QPoint &p) const
+CQDockAreaEventFilter::
+eventFilter(QObject *obj, QEvent *event)
 {
-  QRect r = childrenRect();
+  QEvent::Type type = event->type();
 
-  return (p.x() < r.left () || p.y() < r.top   () ||
-          p.x() > r.right() || p.y() > r.bottom());
+  if      (type == QEvent::MouseButtonPress) {
+    auto p = targets_.find(obj);
+
+    if (p != targets_.end()) {
+      pressArea_ = p.value();
+
+      pressArea_->handlePress(obj, static_cast<QMouseEvent *>(event));
+    }
+  }
+  else if (type == QEvent::MouseButtonRelease) {
+    if (pressArea_) {
+      pressArea_->handleRelease();
+
+      pressArea_ = nullptr;
+    }
+  }
+  else if (type == QEvent::Resize) {
+    if (obj == window_->centralWidget()) {
+      for (auto *area : areas_)
+        emit area->centralWidgetResized();
+    }
+  }
+
+  return QObject::eventFilter(obj, event);
 }
@@ -1,6 +1,8 @@
 #include <CQPaletteArea.h>
 #include <CQPaletteGroup.h>
 #include <CQPalettePreview.h>
+#include <CQPaletteDragGhost.h>
+#include <CQPaletteDropIndicator.h>
 
 #include <CQSplitterArea.h>
 #include <CQWidgetResizer.h>
@@ -22,6 +24,7 @@
 #include <QTimer>
 #include <QScreen>
 
+#include <algorithm>
 #include <cassert>
 #include <iostream>
 
@@ -38,12 +41,72 @@ namespace Constants {
   Qt::WindowFlags detachedFlags = Qt::Tool | Qt::FramelessWindowHint;
 };
 
+namespace TitleIcons {
+  // get title button pixmap (decoded from xpm once per process)
+  const QPixmap &pixmap(TitleIcon icon) {
+    static QPixmap pixmaps[4];
+
+    QPixmap &pixmap = pixmaps[int(icon)];
+
+    if (pixmap.isNull()) {
+      switch (icon) {
+        case TitleIcon::Pin          : pixmap = QPixmap(pin_data           ); break;
+        case TitleIcon::Unpin        : pixmap = QPixmap(unpin_data         ); break;
+        case TitleIcon::LeftTriangle : pixmap = QPixmap(left_triangle_data ); break;
+        case TitleIcon::RightTriangle: pixmap = QPixmap(right_triangle_data); break;
+        default                      : assert(false); break;
+      }
+    }
+
+    return pixmap;
+  }
+
+  // update title button icon and tooltip (only if changed)
+  bool updateButton(CQTitleBarButton *button, CQTitleButtonState &state,
+                    TitleIcon icon, const QString &tip) {
+    bool changed = false;
+
+    if (icon != state.icon) {
+      button->setIcon(pixmap(icon));
+
+      state.icon = icon;
+
+      changed = true;
+    }
+
+    if (tip != state.tip) {
+      button->setToolTip(tip);
+
+      state.tip = tip;
+
+      changed = true;
+    }
+
+    return changed;
+  }
+
+  // update title button visible (only if changed)
+  bool updateButtonVisible(CQTitleBarButton *button, bool visible) {
+    if (button->isHidden() != visible)
+      return false;
+
+    button->setVisible(visible);
+
+    return true;
+  }
+}
+
 CQPaletteAreaMgr::
 CQPaletteAreaMgr(QMainWindow *window) :
- window_(window)
+ window_(window), dragMode_(DragMode::Live),
+ splitterResizeMode_(CQSplitterArea::ResizeMode::Immediate), dragGhost_(nullptr),
+ dragSource_(nullptr), updateDepth_(0), updatePosted_(false)
 {
   setObjectName("mgr");
 
+  // single application event filter shared by all areas (must exist before areas)
+  dockAreaFilter_ = new CQDockAreaEventFilter(window_, this);
+
   Qt::DockWidgetArea dockAreas[] = {
     Qt::LeftDockWidgetArea, Qt::RightDockWidgetArea,
     Qt::TopDockWidgetArea , Qt::BottomDockWidgetArea
@@ -58,6 +121,8 @@ CQPaletteAreaMgr(QMainWindow *window) :
   rubberBand_ = new CQRubberBand;
 
   rubberBand_->hide();
+
+  dropIndicator_ = new CQPaletteDropIndicator(window_);
 }
 
 CQPaletteAreaMgr::
@@ -71,6 +136,8 @@ CQPaletteAreaMgr::
   }
 
   delete rubberBand_;
+
+  delete dragGhost_;
 }
 
 QString
@@ -109,10 +176,14 @@ createArea(Qt::DockWidgetArea dockArea)
 
   area->setObjectName(dockAreaName(dockArea));
 
+  area->splitter()->setResizeMode(splitterResizeMode_);
+
   palettes_[dockArea].push_back(area);
 
   area->setVisible(false);
 
+  invalidateDropIndex();
+
   return area;
 }
 
@@ -138,12 +209,18 @@ deleteArea(CQPaletteArea *area)
   area->setVisible(false);
 
   area->deleteLater();
+
+  ensureAttachedAreas();
+
+  invalidateDropIndex();
 }
 
 void
 CQPaletteAreaMgr::
 addPage(CQPaletteAreaPage *page, Qt::DockWidgetArea dockArea)
 {
+  UpdateGuard guard(this);
+
   CQPaletteArea *area = getArea(dockArea);
 
   area->addPage(page);
@@ -153,6 +230,8 @@ void
 CQPaletteAreaMgr::
 removePage(CQPaletteAreaPage *page)
 {
+  UpdateGuard guard(this);
+
   CQPaletteGroup *group = page->group();
   assert(group);
 
@@ -166,6 +245,8 @@ void
 CQPaletteAreaMgr::
 showExpandedPage(CQPaletteAreaPage *page)
 {
+  UpdateGuard guard(this);
+
   CQPaletteGroup *group = page->group();
 
   if (! group) {
@@ -186,6 +267,8 @@ void
 CQPaletteAreaMgr::
 hidePage(CQPaletteAreaPage *page)
 {
+  UpdateGuard guard(this);
+
   CQPaletteGroup *group = page->group();
 
   if (! group) {
@@ -200,6 +283,152 @@ hidePage(CQPaletteAreaPage *page)
   window->hidePage(page);
 }
 
+void
+CQPaletteAreaMgr::
+setSplitterResizeMode(CQSplitterArea::ResizeMode mode)
+{
+  splitterResizeMode_ = mode;
+
+  for (Palettes::iterator p = palettes_.begin(); p != palettes_.end(); ++p) {
+    Areas &areas = (*p).second;
+
+    for (Areas::iterator pa = areas.begin(); pa != areas.end(); ++pa)
+      (*pa)->splitter()->setResizeMode(mode);
+  }
+}
+
+void
+CQPaletteAreaMgr::
+beginUpdate()
+{
+  ++updateDepth_;
+}
+
+void
+CQPaletteAreaMgr::
+endUpdate()
+{
+  assert(updateDepth_ > 0);
+
+  if (--updateDepth_ > 0)
+    return;
+
+  flushUpdates();
+}
+
+bool
+CQPaletteAreaMgr::
+deferUpdate(CQPaletteArea *area, uint flags)
+{
+  if (! isUpdating())
+    return false;
+
+  addPendingUpdate(area, flags);
+
+  return true;
+}
+
+void
+CQPaletteAreaMgr::
+scheduleUpdate(CQPaletteArea *area, uint flags)
+{
+  addPendingUpdate(area, flags);
+
+  // batched update flushes on endUpdate, otherwise flush once from event loop
+  if (! isUpdating() && ! updatePosted_) {
+    updatePosted_ = true;
+
+    QMetaObject::invokeMethod(this, "flushUpdatesSlot", Qt::QueuedConnection);
+  }
+}
+
+void
+CQPaletteAreaMgr::
+addPendingUpdate(CQPaletteArea *area, uint flags)
+{
+  for (auto &update : pendingUpdates_) {
+    if (update.first == area) {
+      update.second |= flags;
+      return;
+    }
+  }
+
+  pendingUpdates_.push_back(std::make_pair(area, flags));
+}
+
+void
+CQPaletteAreaMgr::
+removePendingUpdates(CQPaletteArea *area)
+{
+  for (auto p = pendingUpdates_.begin(); p != pendingUpdates_.end(); ++p) {
+    if ((*p).first == area) {
+      pendingUpdates_.erase(p);
+      break;
+    }
+  }
+}
+
+void
+CQPaletteAreaMgr::
+flushUpdates()
+{
+  // run current updates once per area, updates scheduled while running
+  // (e.g. from resize events) are posted to next event loop iteration
+  PendingUpdates updates;
+
+  std::swap(updates, pendingUpdates_);
+
+  for (const auto &update : updates) {
+    CQPaletteArea *area  = update.first;
+    uint           flags = update.second;
+
+    if (flags & UpdateSplitter) area->updateSplitterSizes();
+
+    if ((flags & UpdateConstraints) && area->isExpanded())
+      area->setSizeConstraints();
+
+    if (flags & UpdateTitle   ) area->updateTitle();
+    if (flags & UpdateSize    ) area->updateSize();
+    if (flags & UpdateLayout  ) area->updateSplitter();
+    if (flags & UpdatePreview ) area->updatePreviewRects();
+  }
+
+  if (! pendingUpdates_.empty() && ! updatePosted_) {
+    updatePosted_ = true;
+
+    QMetaObject::invokeMethod(this, "flushUpdatesSlot", Qt::QueuedConnection);
+  }
+}
+
+void
+CQPaletteAreaMgr::
+flushUpdatesSlot()
+{
+  updatePosted_ = false;
+
+  // batched update will flush on endUpdate
+  if (isUpdating())
+    return;
+
+  flushUpdates();
+}
+
+void
+CQPaletteAreaMgr::
+discardHiddenPages()
+{
+  for (Palettes::iterator p = palettes_.begin(); p != palettes_.end(); ++p) {
+    Areas &areas = (*p).second;
+
+    for (Areas::iterator pa = areas.begin(); pa != areas.end(); ++pa) {
+      const CQPaletteArea::Windows &windows = (*pa)->windows();
+
+      for (auto *window : windows)
+        window->group()->discardHiddenPages();
+    }
+  }
+}
+
 CQPaletteWindow *
 CQPaletteAreaMgr::
 addWindow(Qt::DockWidgetArea dockArea)
@@ -223,53 +452,181 @@ CQPaletteArea *
 CQPaletteAreaMgr::
 getAreaAt(const QPoint &pos, Qt::DockWidgetAreas allowedAreas) const
 {
-  for (Palettes::const_iterator p = palettes_.begin(); p != palettes_.end(); ++p) {
+  updateDropIndex();
+
+  // check all areas (cached rects, in palette order)
+  for (const auto &target : dropIndex_.targets) {
+    CQPaletteArea *area = target.area;
+
+    if (area->isDetached() && ! area->isVisible()) continue;
+
+    if (! (area->dockArea() & allowedAreas))
+      continue;
+
+    if (target.rect.contains(pos))
+      return area;
+  }
+
+  return nullptr;
+}
+
+void
+CQPaletteAreaMgr::
+ensureAttachedAreas()
+{
+  // ensure each side has an attached (non-detached) area to drop on
+  for (Palettes::iterator p = palettes_.begin(); p != palettes_.end(); ++p) {
     Qt::DockWidgetArea  dockArea = (*p).first;
     const Areas        &areas    = (*p).second;
 
-    // ensure we have an attach dock area
     bool hasAttached = false;
 
     for (Areas::const_iterator pa = areas.begin(); pa != areas.end(); ++pa) {
-      CQPaletteArea *area = *pa;
-
-      if (! area->isDetached()) {
+      if (! (*pa)->isDetached()) {
         hasAttached = true;
         break;
       }
     }
 
-    if (! hasAttached) {
-      CQPaletteAreaMgr *th = const_cast<CQPaletteAreaMgr *>(this);
+    if (! hasAttached)
+      (void) createArea(dockArea);
+  }
+}
 
-      CQPaletteArea *area = new CQPaletteArea(th, dockArea);
+void
+CQPaletteAreaMgr::
+updateDropIndex() const
+{
+  QRect windowRect = window_->geometry();
 
-      area->setObjectName(dockAreaName(dockArea));
+  if (dropIndex_.valid && dropIndex_.windowRect == windowRect)
+    return;
 
-      th->palettes_[dockArea].push_back(area);
+  int tol = Constants::splitter_tol;
 
-      area->setVisible(false);
-    }
+  dropIndex_.targets.clear();
 
-    // check all areas
+  // attached areas are ensured on structural changes (no widget creation here)
+  for (Palettes::const_iterator p = palettes_.begin(); p != palettes_.end(); ++p) {
+    const Areas &areas = (*p).second;
+
+    // cache global rects of area and its visible splitter children
     for (Areas::const_iterator pa = areas.begin(); pa != areas.end(); ++pa) {
       CQPaletteArea *area = *pa;
 
-      if (area->isDetached() && ! area->isVisible()) continue;
+      // ghost dragged area is detached on drop so is not a target
+      if (area == dragSource_) continue;
+
+      DropTarget target;
+
+      target.area     = area;
+      target.rect     = area->getHighlightRect(dragSource_);
+      target.vertical = area->isVerticalDockArea();
 
-      if (! (area->dockArea() & allowedAreas))
-        continue;
+      if (! area->isFloating()) {
+        QSplitter *splitter = area->splitter()->splitter();
 
-      QRect rect = area->getHighlightRect();
+        for (int i = 0; i < splitter->count(); ++i) {
+          QWidget *widget = splitter->widget(i);
 
-      if (rect.contains(pos))
-        return area;
+          // ghost dragged window is removed from splitter on drop
+          if (widget->isHidden() || widget == dragSource_) continue;
+
+          DropTarget::Child child;
+
+          child.window = qobject_cast<CQPaletteWindow *>(widget);
+          child.pos    = widget->mapToGlobal(QPoint(0, 0));
+          child.size = QSize(std::max(widget->width(), 2*tol), std::max(widget->height(), 2*tol));
+
+          child.start = (target.vertical ? child.pos.y() : child.pos.x());
+          child.end   = child.start + (target.vertical ? child.size.height() : child.size.width());
+
+          target.children.push_back(child);
+        }
+      }
+
+      dropIndex_.targets.push_back(target);
     }
   }
 
+  dropIndex_.windowRect = windowRect;
+  dropIndex_.valid      = true;
+}
+
+const CQPaletteAreaMgr::DropTarget *
+CQPaletteAreaMgr::
+getDropTarget(CQPaletteArea *area) const
+{
+  updateDropIndex();
+
+  for (const auto &target : dropIndex_.targets) {
+    if (target.area == area)
+      return &target;
+  }
+
   return nullptr;
 }
 
+QRect
+CQPaletteAreaMgr::
+getDropTargetRect(const DropTarget &target, const QPoint &gpos, DropPos *dropPos) const
+{
+  int tol = Constants::splitter_tol;
+
+  const DropTarget::Children &children = target.children;
+
+  int pos = (target.vertical ? gpos.y() : gpos.x());
+
+  // first child whose extent (plus tolerance) ends after pos
+  auto pc = std::upper_bound(children.begin(), children.end(), pos,
+    [&](int p, const DropTarget::Child &child) { return p < child.end + tol; });
+
+  if (pc == children.end() || pos <= (*pc).start - tol) {
+    if (dropPos) {
+      dropPos->area   = target.area;
+      dropPos->window = nullptr;
+      dropPos->side   = DropSide::Area;
+    }
+
+    return target.rect;
+  }
+
+  const DropTarget::Child &child = *pc;
+
+  int w = child.size.width ();
+  int h = child.size.height();
+
+  int d = pos - child.start;
+  int l = (target.vertical ? h : w);
+
+  DropSide side;
+
+  if      (d >    - tol && d <      tol) side = DropSide::Before;
+  else if (d >  l - tol && d <  l + tol) side = DropSide::After;
+  else                                   side = DropSide::Merge;
+
+  QRect rect;
+
+  if (target.vertical) {
+    if      (side == DropSide::Before) rect = QRect(0,   - tol, w,     2*tol);
+    else if (side == DropSide::After ) rect = QRect(0, h - tol, w,     2*tol);
+    else                               rect = QRect(0,     tol, w, h - 2*tol);
+  }
+  else {
+    if      (side == DropSide::Before) rect = QRect(  - tol, 0,     2*tol, h);
+    else if (side == DropSide::After ) rect = QRect(w - tol, 0,     2*tol, h);
+    else                               rect = QRect(tol    , 0, w - 2*tol, h);
+  }
+
+  if (dropPos) {
+    dropPos->area   = target.area;
+    dropPos->window = child.window;
+    dropPos->side   = (child.window ? side : DropSide::Area);
+  }
+
+  return rect.translated(child.pos);
+}
+
 void
 CQPaletteAreaMgr::
 swapAreas(CQPaletteArea *area1, CQPaletteArea *area2)
@@ -316,24 +673,104 @@ swapAreas(CQPaletteArea *area1, CQPaletteArea *area2)
 
   area1->updateDockArea();
   area2->updateDockArea();
+
+  ensureAttachedAreas();
+
+  invalidateDropIndex();
 }
 
 void
 CQPaletteAreaMgr::
 highlightArea(CQPaletteArea *area, const QPoint &p)
 {
-  QRect rect = area->getHighlightRectAtPos(p);
+  const DropTarget *target = getDropTarget(area);
+
+  // remember highlighted position so drop acts on what is shown
+  QRect rect;
 
-  rubberBand_->setGeometry(rect);
+  if (target)
+    rect = getDropTargetRect(*target, p, &dropPos_);
+  else {
+    rect = area->getHighlightRectAtPos(p);
 
-  rubberBand_->show();
+    dropPos_      = DropPos();
+    dropPos_.area = area;
+  }
+
+  // detached/floating areas are outside main window so need top level rubber band
+  bool overlay = (! area->isDetached() && ! area->isFloating() &&
+                  QRect(window_->mapToGlobal(QPoint(0, 0)), window_->size()).intersects(rect));
+
+  if (overlay) {
+    rubberBand_->hide();
+
+    dropIndicator_->setGlobalRect(rect);
+  }
+  else {
+    dropIndicator_->hide();
+
+    rubberBand_->setGeometry(rect);
+
+    rubberBand_->show();
+  }
 }
 
 void
 CQPaletteAreaMgr::
 clearHighlight()
 {
-  rubberBand_->hide();
+  rubberBand_   ->hide();
+  dropIndicator_->hide();
+
+  dropPos_ = DropPos();
+}
+
+void
+CQPaletteAreaMgr::
+setDragSource(QWidget *w)
+{
+  if (w == dragSource_)
+    return;
+
+  dragSource_ = w;
+
+  invalidateDropIndex();
+}
+
+void
+CQPaletteAreaMgr::
+startGhostDrag(QWidget *w)
+{
+  if (! dragGhost_)
+    dragGhost_ = new CQPaletteDragGhost;
+
+  dragGhost_->start(w);
+}
+
+void
+CQPaletteAreaMgr::
+startGhostDrag(QWidget *w, QWidget *tabbar, const QRect &tabRect)
+{
+  if (! dragGhost_)
+    dragGhost_ = new CQPaletteDragGhost;
+
+  dragGhost_->start(w, tabbar, tabRect);
+}
+
+void
+CQPaletteAreaMgr::
+moveGhostDrag(const QPoint &d)
+{
+  if (dragGhost_)
+    dragGhost_->moveBy(d);
+}
+
+void
+CQPaletteAreaMgr::
+stopGhostDrag()
+{
+  if (dragGhost_)
+    dragGhost_->stop();
 }
 
 //------
@@ -343,7 +780,8 @@ int CQPaletteArea::windowId_ = 1;
 CQPaletteArea::
 CQPaletteArea(CQPaletteAreaMgr *mgr, Qt::DockWidgetArea dockArea) :
  CQDockArea(mgr->window()), mgr_(mgr), windowState_(NormalState), hideTitle_(true),
- visible_(true), expanded_(true), pinned_(true), floating_(false), detached_(false)
+ visible_(true), expanded_(true), pinned_(true), floating_(false), detached_(false),
+ restoreSize_(-1)
 {
   setObjectName(mgr->dockAreaName(dockArea));
 
@@ -393,12 +831,18 @@ CQPaletteArea(CQPaletteAreaMgr *mgr, Qt::DockWidgetArea dockArea) :
 
   connect(this, SIGNAL(centralWidgetResized()), this, SLOT(updateSplitter()));
 
+  mgr_->dockAreaFilter()->addArea(this, splitter_->handle());
+
   updateTitle();
 }
 
 CQPaletteArea::
 ~CQPaletteArea()
 {
+  mgr_->dockAreaFilter()->removeArea(this);
+
+  mgr_->removePendingUpdates(this);
+
   delete previewHandler_;
   delete noTitle_;
 }
@@ -455,80 +899,41 @@ addWindow(CQPaletteWindow *window)
   updateTitle();
 
   updateSize();
+
+  mgr_->invalidateDropIndex();
+
+  updatePreview();
 }
 
 void
 CQPaletteArea::
-addWindowAtPos(CQPaletteWindow *window, const QPoint &gpos)
+addWindowAt(CQPaletteWindow *window, CQPaletteWindow *target, CQPaletteAreaMgr::DropSide side)
 {
-  int tol = Constants::splitter_tol;
+  using DropSide = CQPaletteAreaMgr::DropSide;
 
   window->setArea(this);
 
-  int pos = -1;
-
-  int n = splitter()->splitter()->count();
-
-  if      (isVerticalDockArea()) {
-    for (int i = 0; i < n; ++i) {
-      QWidget *widget = splitter()->splitter()->widget(i);
-
-      int y = widget->mapFromGlobal(gpos).y();
-      int h = widget->height();
-
-      if      (y > -tol && y < tol) {
-        pos = i;
-        break;
-      }
-      else if (y > h - tol && y < h + tol) {
-        pos = i + 1;
-        break;
-      }
-      else if (y >= tol && y <= h - tol) {
-        CQPaletteWindow *window1 = qobject_cast<CQPaletteWindow *>(widget);
+  if (target == window)
+    target = nullptr;
 
-        auto numPages = window->group()->numPages();
+  // merge pages into target window
+  if (target && side == DropSide::Merge) {
+    CQPaletteGroup::PageArray pages;
 
-        for (uint j = 0; j < numPages; ++j)
-          window1->addPage(window->group()->getPage(int(j)));
+    window->group()->getAllPages(pages);
 
-        window1->setCurrentPage(window->group()->getPage(0));
+    window->movePages(pages, target, window->currentPage());
 
-        window->deleteLater();
+    window->deleteLater();
 
-        return;
-      }
-    }
+    return;
   }
-  else if (isHorizontalDockArea()) {
-    for (int i = 0; i < n; ++i) {
-      QWidget *widget = splitter()->splitter()->widget(i);
-
-      int x = widget->mapFromGlobal(gpos).x();
-      int w = widget->width();
 
-      if      (x > -tol && x < tol) {
-        pos = i;
-        break;
-      }
-      else if (x > w - tol && x < w + tol) {
-        pos = i + 1;
-        break;
-      }
-      else if (x >= tol && x <= w - tol) {
-        CQPaletteWindow *window1 = qobject_cast<CQPaletteWindow *>(widget);
+  // insert before/after target window (or add at end)
+  int pos = (target ? splitter()->splitter()->indexOf(target) : -1);
 
-        auto numPages = window->group()->numPages();
-
-        for (uint j = 0; j < numPages; ++j)
-          window1->addPage(window->group()->getPage(int(j)));
-
-        window->deleteLater();
-
-        return;
-      }
-    }
-  }
+  if (pos >= 0 && side == DropSide::After)
+    ++pos;
 
   window->setVisible(true);
 
@@ -553,6 +958,10 @@ addWindowAtPos(CQPaletteWindow *window, const QPoint &gpos)
   updateTitle();
 
   updateSize();
+
+  mgr_->invalidateDropIndex();
+
+  updatePreview();
 }
 
 void
@@ -584,18 +993,22 @@ removeWindow(CQPaletteWindow *window)
   updateTitle();
 
   updateSize();
+
+  mgr_->invalidateDropIndex();
+
+  updatePreview();
 }
 
 uint
 CQPaletteArea::
-numVisibleWindows() const
+numVisibleWindows(const QWidget *exclude) const
 {
   uint num = 0;
 
   for (Windows::const_iterator p = windows_.begin(); p != windows_.end(); ++p) {
     CQPaletteWindow *window = *p;
 
-    if (! window->isVisible() || window->isDetached())
+    if (! window->isVisible() || window->isDetached() || window == exclude)
       continue;
 
     ++num;
@@ -648,10 +1061,25 @@ void
 CQPaletteArea::
 updateSplitterSizes()
 {
-  QList<int> sizes;
+  if (mgr_->deferUpdate(this, CQPaletteAreaMgr::UpdateSplitter))
+    return;
 
   int n = splitter()->splitter()->count();
 
+  // use restored sizes if they still match the splitter windows
+  if (! restoreSizes_.isEmpty()) {
+    QList<int> sizes;
+
+    std::swap(sizes, restoreSizes_);
+
+    if (sizes.size() == n) {
+      splitter()->splitter()->setSizes(sizes);
+      return;
+    }
+  }
+
+  QList<int> sizes;
+
   if      (isVerticalDockArea()) {
     int h = splitter()->height();
 
@@ -902,15 +1330,21 @@ updatePreviewState()
 {
   previewHandler_->setActive(expanded_ && ! pinned_ && ! isFloating() && ! isDetached());
 
-  updatePreview();
+  if (previewHandler_->active())
+    updatePreview();
+  else
+    previewHandler_->clear();
 }
 
 void
 CQPaletteArea::
 updatePreview()
 {
+  if (! previewHandler_->active())
+    return;
+
   // clear existing data
-  previewHandler_->clear();
+  previewHandler_->clearWidgets();
 
   // add preview widgets (for auto hide)
   for (Windows::iterator p = windows_.begin(); p != windows_.end(); ++p) {
@@ -918,12 +1352,24 @@ updatePreview()
 
     CQPaletteAreaPage *page = window->currentPage();
 
-    if (page)
+    if (page && page->widget())
       previewHandler_->addWidget(page->widget());
   }
 
   previewHandler_->addWidget(this);
 
+  updatePreviewRects();
+}
+
+void
+CQPaletteArea::
+updatePreviewRects()
+{
+  if (! previewHandler_->active())
+    return;
+
+  previewHandler_->clearRects();
+
   // add rectangle for whole palette and resize area
   QPoint p = mapToGlobal(rect().topLeft());
 
@@ -985,6 +1431,10 @@ setDetached(bool detached)
   updateTitle();
 
   updatePreviewState();
+
+  // side may have lost its attached area
+  if (detached_)
+    mgr_->ensureAttachedAreas();
 }
 
 // update floating state
@@ -997,6 +1447,9 @@ setFloating(bool floating)
 
   floating_ = floating;
 
+  // geometry changes are ignored while floating
+  mgr_->invalidateDropIndex();
+
   updateSizeConstraints();
 
   updatePreviewState();
@@ -1022,7 +1475,7 @@ setFloated(bool floating, const QPoint &pos, bool /*dragAll*/)
       move(detachPos, detachPos);
     }
 
-    allowedAreas_ = calcAllowedAreas();
+    updateDragAllowedAreas();
   }
   else {
     setWindowState(NormalState);
@@ -1035,6 +1488,13 @@ setFloated(bool floating, const QPoint &pos, bool /*dragAll*/)
   setVisible(true);
 }
 
+void
+CQPaletteArea::
+updateDragAllowedAreas()
+{
+  allowedAreas_ = calcAllowedAreas();
+}
+
 Qt::DockWidgetAreas
 CQPaletteArea::
 calcAllowedAreas() const
@@ -1079,9 +1539,14 @@ animateDrop(const QPoint &p)
 
 void
 CQPaletteArea::
-execDrop(const QPoint &gpos, bool floating)
+execDrop(const QPoint &, bool floating)
 {
-  CQPaletteArea *area = mgr_->getAreaAt(gpos, allowedAreas());
+  CQPaletteAreaMgr::UpdateGuard guard(mgr_);
+
+  // drop on highlighted target (layout changes when floated so don't query again)
+  CQPaletteAreaMgr::DropPos drop = mgr_->dropPos();
+
+  CQPaletteArea *area = drop.area;
 
   if (area && (area != this || floating)) {
     setFloated (false);
@@ -1100,7 +1565,7 @@ execDrop(const QPoint &gpos, bool floating)
 
           this->removeWindow(window);
 
-          area->addWindowAtPos(window, gpos);
+          area->addWindowAt(window, drop.window, drop.side);
         }
 
         mgr_->window()->addDockWidget(area->dockArea(), area);
@@ -1194,7 +1659,7 @@ getHighlightRectAtPos(const QPoint &gpos) const
 
 QRect
 CQPaletteArea::
-getHighlightRect() const
+getHighlightRect(const QWidget *exclude) const
 {
   int tol = Constants::splitter_tol;
 
@@ -1210,7 +1675,7 @@ getHighlightRect() const
   QRect rect;
 
   // visible docked area
-  if (! isFloating() && numVisibleWindows() != 0) {
+  if (! isFloating() && numVisibleWindows(exclude) != 0) {
     rect = geometry();
 
     if (! isDetached())
@@ -1263,6 +1728,8 @@ void
 CQPaletteArea::
 dockAt(Qt::DockWidgetArea dockArea)
 {
+  CQPaletteAreaMgr::UpdateGuard guard(mgr_);
+
   CQPaletteArea *area = mgr_->getArea(dockArea);
 
   if (area->windows_.empty()) {
@@ -1314,6 +1781,9 @@ void
 CQPaletteArea::
 updateTitle()
 {
+  if (mgr_->deferUpdate(this, CQPaletteAreaMgr::UpdateTitle))
+    return;
+
   QWidget *titleWidget = title_;
 
   if (hideTitle())
@@ -1334,9 +1804,17 @@ resizeEvent(QResizeEvent *e)
 {
   CQDockArea::resizeEvent(e);
 
-  updateSplitter();
+  // dragged (floating) area is not a drop target
+  if (! isFloating())
+    mgr_->invalidateDropIndex();
 
-  updatePreviewState();
+  // coalesce splitter layout and preview rects update (once per event loop)
+  uint flags = CQPaletteAreaMgr::UpdateLayout;
+
+  if (previewHandler_->active())
+    flags |= CQPaletteAreaMgr::UpdatePreview;
+
+  mgr_->scheduleUpdate(this, flags);
 }
 
 void
@@ -1345,7 +1823,13 @@ moveEvent(QMoveEvent *e)
 {
   CQDockArea::moveEvent(e);
 
-  updateSplitter();
+  if (! isFloating())
+    mgr_->invalidateDropIndex();
+
+  mgr_->scheduleUpdate(this, CQPaletteAreaMgr::UpdateLayout);
+
+  // preview rects are in global coords
+  updatePreviewRects();
 }
 
 void
@@ -1359,6 +1843,14 @@ void
 CQPaletteArea::
 updateSize()
 {
+  if (mgr_->deferUpdate(this, CQPaletteAreaMgr::UpdateSize))
+    return;
+
+  // restored dock size replaces size hint (once)
+  int restoreSize = restoreSize_;
+
+  restoreSize_ = -1;
+
   if (numVisibleWindows() == 0)
     setVisible(false);
   else {
@@ -1366,6 +1858,13 @@ updateSize()
 
     QSize s = sizeHint();
 
+    if (restoreSize >= 0) {
+      if (isVerticalDockArea())
+        s.setWidth(restoreSize);
+      else
+        s.setHeight(restoreSize);
+    }
+
     bool fixed = false;
 
     if      (isVerticalDockArea()) {
@@ -1473,6 +1972,42 @@ moveSplitter(int d)
   return true;
 }
 
+int
+CQPaletteArea::
+clampSplitterDelta(int d) const
+{
+  if      (isVerticalDockArea()) {
+    int min_w, max_w;
+
+    getDockMinMaxWidth(min_w, max_w);
+
+    int w = this->width();
+
+    // left grows with delta, right shrinks
+    int sign = (dockArea() == Qt::LeftDockWidgetArea ? 1 : -1);
+
+    int w1 = std::min(std::max(w + sign*d, min_w), std::max(max_w, min_w));
+
+    return sign*(w1 - w);
+  }
+  else if (isHorizontalDockArea()) {
+    int min_h, max_h;
+
+    getDockMinMaxHeight(min_h, max_h);
+
+    int h = this->height();
+
+    // top grows with delta, bottom shrinks
+    int sign = (dockArea() == Qt::TopDockWidgetArea ? 1 : -1);
+
+    int h1 = std::min(std::max(h + sign*d, min_h), std::max(max_h, min_h));
+
+    return sign*(h1 - h);
+  }
+
+  return 0;
+}
+
 void
 CQPaletteArea::
 getDockMinMaxWidth(int &min_w, int &max_w) const
@@ -1695,6 +2230,24 @@ movePage(CQPaletteAreaPage *page, CQPaletteWindow *newWindow)
   }
 }
 
+void
+CQPaletteWindow::
+movePages(const Pages &pages, CQPaletteWindow *newWindow, CQPaletteAreaPage *current)
+{
+  if (pages.empty() || newWindow == this)
+    return;
+
+  CQPaletteAreaMgr::UpdateGuard guard(mgr_);
+
+  group_->movePages(pages, newWindow->group_, current);
+
+  if (newWindow->group_->numPages() > 0)
+    newWindow->setVisible(true);
+
+  if (newWindow->area_)
+    newWindow->area_->updateSize();
+}
+
 void
 CQPaletteWindow::
 deleteLaterSlot()
@@ -1790,8 +2343,12 @@ pageChangedSlot(CQPaletteAreaPage *)
 {
   title_->update();
 
+  // current page widget is a preview widget
+  area_->updatePreview();
+
+  // coalesce size constraint update (expanded state checked when run)
   if (area_->isExpanded())
-    area_->setSizeConstraints();
+    mgr_->scheduleUpdate(area_, CQPaletteAreaMgr::UpdateConstraints);
 }
 
 CQPaletteWindow::Pages
@@ -1869,14 +2426,21 @@ setFloated(bool floating, const QPoint &pos, bool dragAll)
 
     CQPaletteAreaPage *currentPage = this->currentPage();
 
-    if (currentPage)
-      allowedAreas_ = currentPage->allowedAreas();
+    updateDragAllowedAreas();
 
     if (! dragAll && pages.size() > 1) {
       QSize saveSize = this->size();
 
       newWindow_ = area_->addWindow();
 
+      // other pages stay in this window's slot (ghost drop target)
+      QSplitter *splitter = area_->splitter()->splitter();
+
+      int ind = splitter->indexOf(this);
+
+      if (ind >= 0)
+        splitter->insertWidget(ind, newWindow_);
+
       parentPos_ = group_->currentIndex();
 
       for (uint i = 0; i < pages.size(); ++i) {
@@ -1923,6 +2487,17 @@ setFloated(bool floating, const QPoint &pos, bool dragAll)
   setVisible(true);
 }
 
+void
+CQPaletteWindow::
+updateDragAllowedAreas()
+{
+  // dragged window takes allowed areas of current page
+  CQPaletteAreaPage *currentPage = this->currentPage();
+
+  if (currentPage)
+    allowedAreas_ = currentPage->allowedAreas();
+}
+
 void
 CQPaletteWindow::
 cancelFloating()
@@ -2012,9 +2587,18 @@ animateDrop(const QPoint &p)
 
 void
 CQPaletteWindow::
-execDrop(const QPoint &gpos, bool /*floating*/)
+execDrop(const QPoint &, bool /*floating*/)
 {
-  CQPaletteArea *area = mgr_->getAreaAt(gpos, allowedAreas());
+  CQPaletteAreaMgr::UpdateGuard guard(mgr_);
+
+  // drop on highlighted target (layout changes when floated so don't query again)
+  CQPaletteAreaMgr::DropPos drop = mgr_->dropPos();
+
+  CQPaletteArea *area = drop.area;
+
+  // other pages of split window (in source slot) replace source as target
+  if (drop.window == this)
+    drop.window = newWindow_;
 
   if (area) {
     if (! detachToArea())
@@ -2026,7 +2610,7 @@ execDrop(const QPoint &gpos, bool /*floating*/)
 
     area_->removeWindow(this);
 
-    area->addWindowAtPos(this, gpos);
+    area->addWindowAt(this, drop.window, drop.side);
 
     if (! area->isDetached())
       mgr_->window()->addDockWidget(area->dockArea(), area);
@@ -2082,9 +2666,25 @@ dockAt(Qt::DockWidgetArea dockArea)
   CQPaletteAreaPage *page = this->currentPage();
   if (! page) return;
 
-  removePage(page);
+  CQPaletteAreaMgr::UpdateGuard guard(mgr_);
+
+  CQPaletteWindow *window = area->getDockedWindow();
+
+  if (! window)
+    window = area->addWindow();
+
+  if (window == this) {
+    setCurrentPage(page);
+    return;
+  }
 
-  area->addPage(page, true);
+  movePages(Pages({page}), window, page);
+
+  if (! group_->numPages()) {
+    area_->removeWindow(this);
+
+    this->deleteLater();
+  }
 }
 
 void
@@ -2282,17 +2882,22 @@ joinSlot()
 
   if (! joinWindow) return;
 
-  CQPaletteGroup::PageArray pages = getPages();
+  CQPaletteGroup::PageArray pages;
 
-  for (uint i = 0; i < pages.size(); ++i) {
-    CQPaletteAreaPage *page = pages[i];
+  group_->getAllPages(pages);
 
-    removePage(page);
+  // last visible page is current (as if pages were added one by one)
+  CQPaletteAreaPage *current = nullptr;
 
-    joinWindow->addPage(page);
+  for (auto *page : pages)
+    if (! page->hidden())
+      current = page;
 
-    joinWindow->setCurrentPage(page);
-  }
+  CQPaletteAreaMgr::UpdateGuard guard(mgr_);
+
+  movePages(pages, joinWindow, current);
+
+  area_->removeWindow(this);
 
   this->deleteLater();
 }
@@ -2327,12 +2932,24 @@ void
 CQPaletteWindow::
 resizeEvent(QResizeEvent *)
 {
+  // dragged (floating) window is not a drop target
+  if (! isFloating())
+    mgr_->invalidateDropIndex();
+
   if (! isDetached() || ! expanded_)
     return;
 
   updateDetachSize();
 }
 
+void
+CQPaletteWindow::
+moveEvent(QMoveEvent *)
+{
+  if (! isFloating())
+    mgr_->invalidateDropIndex();
+}
+
 void
 CQPaletteWindow::
 updateDetachSize()
@@ -2371,8 +2988,11 @@ CQPaletteAreaTitle::
 CQPaletteAreaTitle(CQPaletteArea *area) :
  area_(area), contextMenu_(nullptr)
 {
-  pinButton_    = addButton(QPixmap(pin_data));
-  expandButton_ = addButton(QPixmap(left_triangle_data));
+  pinButton_    = addButton(TitleIcons::pixmap(TitleIcon::Pin));
+  expandButton_ = addButton(TitleIcons::pixmap(TitleIcon::LeftTriangle));
+
+  pinState_   .icon = TitleIcon::Pin;
+  expandState_.icon = TitleIcon::LeftTriangle;
 
   connect(pinButton_   , SIGNAL(clicked()), this, SLOT(pinSlot()));
   connect(expandButton_, SIGNAL(clicked()), this, SLOT(expandSlot()));
@@ -2478,49 +3098,41 @@ void
 CQPaletteAreaTitle::
 updateState()
 {
-  if (area_->isExpanded()) {
-    pinButton_->setVisible(true);
+  using namespace TitleIcons;
 
-    if (area_->isPinned()) {
-      pinButton_->setIcon(QPixmap(unpin_data));
+  bool changed = false;
 
-      pinButton_->setToolTip("Unpin");
-    }
-    else {
-      pinButton_->setIcon(QPixmap(pin_data));
+  if (area_->isExpanded()) {
+    changed |= updateButtonVisible(pinButton_, true);
 
-      pinButton_->setToolTip("Pin");
-    }
+    if (area_->isPinned())
+      changed |= updateButton(pinButton_, pinState_, TitleIcon::Unpin, "Unpin");
+    else
+      changed |= updateButton(pinButton_, pinState_, TitleIcon::Pin, "Pin");
   }
   else
-    pinButton_->setVisible(false);
+    changed |= updateButtonVisible(pinButton_, false);
 
   pinButton_->setEnabled(! area_->isFloating() && ! area_->isDetached());
 
-  if (area_->isExpanded()) {
-    if      (area_->dockArea() == Qt::LeftDockWidgetArea ||
-             area_->dockArea() == Qt::BottomDockWidgetArea)
-      expandButton_->setIcon(QPixmap(left_triangle_data));
-    else if (area_->dockArea() == Qt::RightDockWidgetArea ||
-             area_->dockArea() == Qt::TopDockWidgetArea)
-      expandButton_->setIcon(QPixmap(right_triangle_data));
+  //---
 
-    expandButton_->setToolTip("Collapse");
-  }
-  else {
-    if      (area_->dockArea() == Qt::LeftDockWidgetArea ||
-             area_->dockArea() == Qt::BottomDockWidgetArea)
-      expandButton_->setIcon(QPixmap(right_triangle_data));
-    else if (area_->dockArea() == Qt::RightDockWidgetArea ||
-             area_->dockArea() == Qt::TopDockWidgetArea)
-      expandButton_->setIcon(QPixmap(left_triangle_data));
+  TitleIcon expandIcon = expandState_.icon;
 
-    expandButton_->setToolTip("Expand");
-  }
+  Qt::DockWidgetArea dockArea = area_->dockArea();
+
+  if      (dockArea == Qt::LeftDockWidgetArea || dockArea == Qt::BottomDockWidgetArea)
+    expandIcon = (area_->isExpanded() ? TitleIcon::LeftTriangle : TitleIcon::RightTriangle);
+  else if (dockArea == Qt::RightDockWidgetArea || dockArea == Qt::TopDockWidgetArea)
+    expandIcon = (area_->isExpanded() ? TitleIcon::RightTriangle : TitleIcon::LeftTriangle);
+
+  changed |= updateButton(expandButton_, expandState_, expandIcon,
+                          (area_->isExpanded() ? "Collapse" : "Expand"));
 
   //---
 
-  updateLayout();
+  if (changed)
+    updateLayout();
 }
 
 void
@@ -2625,6 +3237,10 @@ mousePressEvent(QMouseEvent *e)
   mouseState_.floating = area_->isFloating();
   mouseState_.dragAll  = (e->modifiers() & Qt::ShiftModifier);
 
+  // possible drag start (ensure drop areas and rebuild drop targets)
+  area_->mgr()->ensureAttachedAreas();
+  area_->mgr()->invalidateDropIndex();
+
   setFocusPolicy(Qt::StrongFocus);
 }
 
@@ -2638,6 +3254,32 @@ mouseMoveEvent(QMouseEvent *e)
       (e->globalPos() - mouseState_.pressPos).manhattanLength() < QApplication::startDragDistance())
     return;
 
+  // ghost drag (move snapshot, float real widget on release)
+  if (mouseState_.ghost ||
+      (! mouseState_.moving && area_->mgr()->dragMode() == CQPaletteAreaMgr::DragMode::Ghost)) {
+    if (! mouseState_.ghost) {
+      mouseState_.ghost   = true;
+      mouseState_.dragPos = mouseState_.pressPos;
+
+      area_->updateDragAllowedAreas();
+
+      // docked area is detached on drop so it is not a drop target
+      area_->mgr()->setDragSource(area_);
+
+      area_->mgr()->startGhostDrag(area_);
+    }
+
+    mouseState_.moving = true;
+
+    area_->mgr()->moveGhostDrag(e->globalPos() - mouseState_.pressPos);
+
+    area_->animateDrop(e->globalPos());
+
+    mouseState_.pressPos = e->globalPos();
+
+    return;
+  }
+
   mouseState_.moving = true;
 
   if (! area_->isFloating())
@@ -2660,8 +3302,19 @@ mouseReleaseEvent(QMouseEvent *e)
   if (! mouseState_.moving || mouseState_.escapePress)
     return;
 
+  // ghost drag: float real widget at ghost position before drop
+  if (mouseState_.ghost) {
+    area_->mgr()->stopGhostDrag();
+
+    area_->setFloated(true, mouseState_.dragPos, mouseState_.dragAll);
+
+    area_->move(area_->pos() + (e->globalPos() - mouseState_.dragPos));
+  }
+
   area_->execDrop(e->globalPos(), mouseState_.floating);
 
+  area_->mgr()->setDragSource(nullptr);
+
   mouseState_.reset();
 
   setFocusPolicy(Qt::NoFocus);
@@ -2674,7 +3327,14 @@ keyPressEvent(QKeyEvent *e)
   if (e->key() == Qt::Key_Escape && ! mouseState_.escapePress) {
     mouseState_.escapePress = true;
 
-    area_->cancelFloating();
+    // ghost drag never floated real widget
+    if (mouseState_.ghost) {
+      area_->mgr()->stopGhostDrag();
+
+      area_->mgr()->setDragSource(nullptr);
+    }
+    else
+      area_->cancelFloating();
 
     area_->clearDrop();
   }
@@ -2726,10 +3386,13 @@ CQPaletteWindowTitle::
 CQPaletteWindowTitle(CQPaletteWindow *window) :
  window_(window), contextMenu_(nullptr)
 {
-  pinButton_    = addButton(QPixmap(pin_data));
-  expandButton_ = addButton(QPixmap(left_triangle_data));
+  pinButton_    = addButton(TitleIcons::pixmap(TitleIcon::Pin));
+  expandButton_ = addButton(TitleIcons::pixmap(TitleIcon::LeftTriangle));
   closeButton_  = addButton(style()->standardIcon(QStyle::SP_TitleBarCloseButton, nullptr, this));
 
+  pinState_   .icon = TitleIcon::Pin;
+  expandState_.icon = TitleIcon::LeftTriangle;
+
   connect(pinButton_   , SIGNAL(clicked()), window_, SLOT(togglePinSlot()));
   connect(expandButton_, SIGNAL(clicked()), window_, SLOT(toggleExpandSlot()));
   connect(closeButton_ , SIGNAL(clicked()), window_, SLOT(closeSlot()));
@@ -2738,6 +3401,9 @@ CQPaletteWindowTitle(CQPaletteWindow *window) :
   expandButton_->setToolTip("Expand");
   closeButton_ ->setToolTip("Close");
 
+  pinState_   .tip = "Pin";
+  expandState_.tip = "Expand";
+
   setAttribute(Qt::WA_Hover);
 
   setFocusPolicy(Qt::NoFocus);
@@ -2775,6 +3441,10 @@ void
 CQPaletteWindowTitle::
 updateState()
 {
+  using namespace TitleIcons;
+
+  bool changed = false;
+
   bool isAreaTitle = window_->isFirstArea();
 
   //---
@@ -2784,52 +3454,38 @@ updateState()
   //---
 
   if (isExpanded) {
-    pinButton_->setVisible(isAreaTitle);
-
-    if (window_->area()->isPinned()) {
-      pinButton_->setIcon(QPixmap(unpin_data));
+    changed |= updateButtonVisible(pinButton_, isAreaTitle);
 
-      pinButton_->setToolTip("Unpin");
-    }
-    else {
-      pinButton_->setIcon(QPixmap(pin_data));
-
-      pinButton_->setToolTip("Pin");
-    }
+    if (window_->area()->isPinned())
+      changed |= updateButton(pinButton_, pinState_, TitleIcon::Unpin, "Unpin");
+    else
+      changed |= updateButton(pinButton_, pinState_, TitleIcon::Pin, "Pin");
   }
   else
-    pinButton_->setVisible(false);
+    changed |= updateButtonVisible(pinButton_, false);
 
   pinButton_->setEnabled(! window_->area()->isFloating() && ! window_->area()->isDetached());
 
   //---
 
-  expandButton_->setVisible(isAreaTitle || window_->isDetached());
+  changed |= updateButtonVisible(expandButton_, isAreaTitle || window_->isDetached());
 
-  if (isExpanded) {
-    if      (window_->dockArea() == Qt::LeftDockWidgetArea ||
-             window_->dockArea() == Qt::BottomDockWidgetArea)
-      expandButton_->setIcon(QPixmap(left_triangle_data));
-    else if (window_->dockArea() == Qt::RightDockWidgetArea ||
-             window_->dockArea() == Qt::TopDockWidgetArea)
-      expandButton_->setIcon(QPixmap(right_triangle_data));
+  TitleIcon expandIcon = expandState_.icon;
 
-    expandButton_->setToolTip("Collapse");
-  }
-  else {
-    if      (window_->dockArea() == Qt::LeftDockWidgetArea ||
-             window_->dockArea() == Qt::BottomDockWidgetArea)
-      expandButton_->setIcon(QPixmap(right_triangle_data));
-    else if (window_->dockArea() == Qt::RightDockWidgetArea ||
-             window_->dockArea() == Qt::TopDockWidgetArea)
-      expandButton_->setIcon(QPixmap(left_triangle_data));
+  Qt::DockWidgetArea dockArea = window_->dockArea();
 
-    expandButton_->setToolTip("Expand");
-  }
+  if      (dockArea == Qt::LeftDockWidgetArea || dockArea == Qt::BottomDockWidgetArea)
+    expandIcon = (isExpanded ? TitleIcon::LeftTriangle : TitleIcon::RightTriangle);
+  else if (dockArea == Qt::RightDockWidgetArea || dockArea == Qt::TopDockWidgetArea)
+    expandIcon = (isExpanded ? TitleIcon::RightTriangle : TitleIcon::LeftTriangle);
+
+  changed |= updateButton(expandButton_, expandState_, expandIcon,
+                          (isExpanded ? "Collapse" : "Expand"));
 
   //---
 
-  updateLayout();
+  if (changed)
+    updateLayout();
 }
 
 void
@@ -2954,9 +3610,42 @@ mousePressEvent(QMouseEvent *e)
   if (window_->isDetached())
     mouseState_.dragAll = true;
 
+  // possible drag start (ensure drop areas and rebuild drop targets)
+  window_->mgr_->ensureAttachedAreas();
+  window_->mgr_->invalidateDropIndex();
+
   setFocusPolicy(Qt::StrongFocus);
 }
 
+void
+CQPaletteWindowTitle::
+startGhostDrag()
+{
+  CQPaletteGroup *group = window_->group();
+
+  CQPaletteAreaPage *page = window_->currentPage();
+
+  // only current page is split off on drop (see CQPaletteWindow::setFloated)
+  if (mouseState_.dragAll || group->numPages() <= 1 || ! page) {
+    // whole window is removed from its slot on drop so it is not a drop target
+    window_->mgr_->setDragSource(window_);
+
+    window_->mgr_->startGhostDrag(window_);
+    return;
+  }
+
+  CQPaletteGroupTabBar *tabbar = group->tabbar();
+
+  QRect tabRect = tabbar->tabRect(tabbar->currentIndex());
+
+  QWidget *w = (page->widget() ? page->widget() : group->stack());
+
+  if (tabRect.isValid())
+    window_->mgr_->startGhostDrag(w, tabbar, tabRect);
+  else
+    window_->mgr_->startGhostDrag(w);
+}
+
 void
 CQPaletteWindowTitle::
 mouseMoveEvent(QMouseEvent *e)
@@ -2967,6 +3656,29 @@ mouseMoveEvent(QMouseEvent *e)
       (e->globalPos() - mouseState_.pressPos).manhattanLength() < QApplication::startDragDistance())
     return;
 
+  // ghost drag (move snapshot, float real widget on release)
+  if (mouseState_.ghost ||
+      (! mouseState_.moving && window_->mgr_->dragMode() == CQPaletteAreaMgr::DragMode::Ghost)) {
+    if (! mouseState_.ghost) {
+      mouseState_.ghost   = true;
+      mouseState_.dragPos = mouseState_.pressPos;
+
+      window_->updateDragAllowedAreas();
+
+      startGhostDrag();
+    }
+
+    mouseState_.moving = true;
+
+    window_->mgr_->moveGhostDrag(e->globalPos() - mouseState_.pressPos);
+
+    window_->animateDrop(e->globalPos());
+
+    mouseState_.pressPos = e->globalPos();
+
+    return;
+  }
+
   mouseState_.moving = true;
 
   if (! window_->isFloating())
@@ -2989,8 +3701,19 @@ mouseReleaseEvent(QMouseEvent *e)
   if (! mouseState_.moving || mouseState_.escapePress)
     return;
 
+  // ghost drag: float real widget at ghost position before drop
+  if (mouseState_.ghost) {
+    window_->mgr_->stopGhostDrag();
+
+    window_->setFloated(true, mouseState_.dragPos, mouseState_.dragAll);
+
+    window_->move(window_->pos() + (e->globalPos() - mouseState_.dragPos));
+  }
+
   window_->execDrop(e->globalPos(), mouseState_.floating);
 
+  window_->mgr_->setDragSource(nullptr);
+
   mouseState_.reset();
 
   setFocusPolicy(Qt::NoFocus);
@@ -3003,7 +3726,14 @@ keyPressEvent(QKeyEvent *e)
   if (e->key() == Qt::Key_Escape && ! mouseState_.escapePress) {
     mouseState_.escapePress = true;
 
-    window_->cancelFloating();
+    // ghost drag never floated real widget
+    if (mouseState_.ghost) {
+      window_->mgr_->stopGhostDrag();
+
+      window_->mgr_->setDragSource(nullptr);
+    }
+    else
+      window_->cancelFloating();
 
     window_->clearDrop();
   }
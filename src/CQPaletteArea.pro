@@ -17,6 +17,8 @@ QMAKE_CXXFLAGS += \
 HEADERS += \
 ../include/CQDockArea.h \
 ../include/CQPaletteArea.h \
+../include/CQPaletteDragGhost.h \
+../include/CQPaletteDropIndicator.h \
 ../include/CQPaletteGroup.h \
 ../include/CQPalettePreview.h \
 ../include/CQRubberBand.h \
@@ -27,6 +29,9 @@ HEADERS += \
 SOURCES += \
 CQDockArea.cpp \
 CQPaletteArea.cpp \
+CQPaletteAreaLayout.cpp \
+CQPaletteDragGhost.cpp \
+CQPaletteDropIndicator.cpp \
 CQPaletteGroup.cpp \
 CQPalettePreview.cpp \
 CQRubberBand.cpp \
@@ -0,0 +1,712 @@
+#include <CQPaletteArea.h>
+#include <CQPaletteGroup.h>
+
+#include <QDataStream>
+#include <QSplitter>
+#include <QHash>
+#include <QSet>
+
+#include <algorithm>
+
+// binary layout state
+//
+//  magic, version, #areas
+//  area   : dock area, flags, dock size, [geometry if detached/floating], #windows
+//  window : splitter size, current page index, #pages
+//  page   : name, hidden
+namespace LayoutState {
+  const quint32 magic   = 0x43515041; // "CQPA"
+  const quint16 version = 1;
+
+  enum AreaFlag {
+    Detached  = (1<<0),
+    Floating  = (1<<1),
+    Collapsed = (1<<2),
+    Unpinned  = (1<<3)
+  };
+
+  struct Page {
+    QString name;
+    bool    hidden { false };
+  };
+
+  struct Window {
+    int               size    { 0 };
+    int               current { -1 };
+    std::vector<Page> pages;
+  };
+
+  struct Area {
+    Qt::DockWidgetArea  dockArea { Qt::LeftDockWidgetArea };
+    uint                flags    { 0 };
+    int                 dockSize { -1 };
+    QRect               rect;
+    std::vector<Window> windows;
+  };
+
+  typedef std::vector<Area> Areas;
+
+  typedef QHash<QString, CQPaletteAreaPage *> PageMap;
+
+  typedef std::vector<std::pair<CQPaletteArea *, const Area *>> AreaStates;
+
+  bool isValidDockArea(uint dockArea) {
+    return (dockArea == Qt::LeftDockWidgetArea || dockArea == Qt::RightDockWidgetArea ||
+            dockArea == Qt::TopDockWidgetArea  || dockArea == Qt::BottomDockWidgetArea);
+  }
+
+  // read whole state (so nothing is changed if state is invalid)
+  bool read(const QByteArray &data, Areas &areas) {
+    QDataStream in(data);
+
+    in.setVersion(QDataStream::Qt_5_0);
+
+    quint32 magic1;
+    quint16 version1;
+
+    in >> magic1 >> version1;
+
+    if (in.status() != QDataStream::Ok || magic1 != magic || version1 != version)
+      return false;
+
+    quint16 numAreas;
+
+    in >> numAreas;
+
+    areas.resize(numAreas);
+
+    for (auto &area : areas) {
+      quint8  dockArea, flags;
+      qint32  dockSize;
+      quint16 numWindows;
+
+      in >> dockArea >> flags >> dockSize;
+
+      if (! isValidDockArea(dockArea))
+        return false;
+
+      area.dockArea = Qt::DockWidgetArea(dockArea);
+      area.flags    = flags;
+      area.dockSize = dockSize;
+
+      if (area.flags & (Detached | Floating))
+        in >> area.rect;
+
+      in >> numWindows;
+
+      area.windows.resize(numWindows);
+
+      for (auto &window : area.windows) {
+        qint32  size;
+        qint16  current;
+        quint16 numPages;
+
+        in >> size >> current >> numPages;
+
+        window.size    = size;
+        window.current = current;
+
+        window.pages.resize(numPages);
+
+        for (auto &page : window.pages) {
+          quint8 hidden;
+
+          in >> page.name >> hidden;
+
+          page.hidden = hidden;
+        }
+
+        if (in.status() != QDataStream::Ok)
+          return false;
+      }
+    }
+
+    return (in.status() == QDataStream::Ok);
+  }
+
+  // lookup pages by name (first page wins for duplicate names)
+  PageMap pageMap(const CQPaletteAreaMgr::Pages &pages) {
+    PageMap namePages;
+
+    for (auto *page : pages) {
+      QString name = page->name();
+
+      if (! name.isEmpty() && ! namePages.contains(name))
+        namePages[name] = page;
+    }
+
+    return namePages;
+  }
+
+  // apply expanded/pinned state (after restored sizes are applied)
+  void applyAreaState(CQPaletteArea *area, const Area &areaState) {
+    if (areaState.flags & Collapsed) {
+      if (area->isExpanded()) {
+        area->collapseSlot();
+
+        // collapse saves current size for expand which may not be laid out yet
+        if (area->isVerticalDockArea())
+          area->setDockWidth(areaState.dockSize);
+        else
+          area->setDockHeight(areaState.dockSize);
+      }
+    }
+    else
+      area->expandSlot();
+
+    if (areaState.flags & Unpinned)
+      area->unpinSlot();
+    else
+      area->pinSlot();
+  }
+}
+
+//------
+
+QByteArray
+CQPaletteAreaMgr::
+saveState() const
+{
+  using namespace LayoutState;
+
+  QByteArray data;
+
+  QDataStream out(&data, QIODevice::WriteOnly);
+
+  out.setVersion(QDataStream::Qt_5_0);
+
+  // areas with windows (in palette order)
+  std::vector<CQPaletteArea *> areas;
+
+  for (Palettes::const_iterator p = palettes_.begin(); p != palettes_.end(); ++p) {
+    const Areas &areas1 = (*p).second;
+
+    for (auto *area : areas1)
+      if (! area->windows().empty())
+        areas.push_back(area);
+  }
+
+  out << magic << version << quint16(areas.size());
+
+  for (auto *area : areas) {
+    uint flags = 0;
+
+    if (  area->isDetached()) flags |= Detached;
+    if (  area->isFloating()) flags |= Floating;
+    if (! area->isExpanded()) flags |= Collapsed;
+    if (! area->isPinned  ()) flags |= Unpinned;
+
+    int dockSize = (area->isVerticalDockArea() ? area->dockWidth() : area->dockHeight());
+
+    out << quint8(area->dockArea()) << quint8(flags) << qint32(dockSize);
+
+    if (flags & (Detached | Floating))
+      out << area->geometry();
+
+    //---
+
+    // windows in splitter order (with sizes), then any not in splitter (floating)
+    const CQPaletteArea::Windows &areaWindows = area->windows();
+
+    QSplitter *splitter = area->splitter()->splitter();
+
+    QList<int> splitterSizes = splitter->sizes();
+
+    CQPaletteArea::Windows windows;
+    std::vector<int>       sizes;
+
+    for (int i = 0; i < splitter->count(); ++i) {
+      auto *window = qobject_cast<CQPaletteWindow *>(splitter->widget(i));
+
+      if (! window || std::find(areaWindows.begin(), areaWindows.end(), window) ==
+                      areaWindows.end())
+        continue;
+
+      windows.push_back(window);
+      sizes  .push_back(splitterSizes.value(i));
+    }
+
+    for (auto *window : areaWindows) {
+      if (std::find(windows.begin(), windows.end(), window) != windows.end())
+        continue;
+
+      windows.push_back(window);
+      sizes  .push_back(0);
+    }
+
+    out << quint16(windows.size());
+
+    for (uint i = 0; i < windows.size(); ++i) {
+      CQPaletteWindow *window = windows[i];
+
+      CQPaletteGroup::PageArray pages;
+
+      window->group()->getAllPages(pages);
+
+      auto pc = std::find(pages.begin(), pages.end(), window->currentPage());
+
+      int current = (pc != pages.end() ? int(pc - pages.begin()) : -1);
+
+      out << qint32(sizes[i]) << qint16(current) << quint16(pages.size());
+
+      for (auto *page : pages)
+        out << page->name() << quint8(page->hidden());
+    }
+  }
+
+  return data;
+}
+
+bool
+CQPaletteAreaMgr::
+restoreState(const QByteArray &state, const Pages &pages)
+{
+  using namespace LayoutState;
+
+  LayoutState::Areas areaStates;
+
+  if (! LayoutState::read(state, areaStates))
+    return false;
+
+  //---
+
+  LayoutState::PageMap namePages = LayoutState::pageMap(pages);
+
+  auto lookupPage = [&](const QString &name) {
+    return namePages.value(name, nullptr);
+  };
+
+  //---
+
+  LayoutState::AreaStates restoreAreas;
+
+  {
+    // build final structure with a single splitter/title/size update per area
+    UpdateGuard guard(this);
+
+    // remove restored pages from their current windows
+    for (const auto &areaState : areaStates) {
+      for (const auto &windowState : areaState.windows) {
+        for (const auto &pageState : windowState.pages) {
+          CQPaletteAreaPage *page = lookupPage(pageState.name);
+
+          // remove from group (window may have remaining hidden pages)
+          if (page && page->group())
+            page->group()->removePage(page);
+        }
+      }
+    }
+
+    // remove emptied windows (no visible or hidden pages), hide windows with only
+    // hidden pages and remove emptied detached areas
+    for (Palettes::iterator p = palettes_.begin(); p != palettes_.end(); ++p) {
+      Areas areas = (*p).second;
+
+      for (auto *area : areas) {
+        CQPaletteArea::Windows windows = area->windows();
+
+        for (auto *window : windows) {
+          CQPaletteGroup::PageArray pages;
+
+          window->group()->getAllPages(pages);
+
+          if      (pages.empty()) {
+            area->removeWindow(window);
+
+            window->deleteLater();
+          }
+          else if (! window->isHidden() && ! window->group()->numPages()) {
+            window->setVisible(false);
+
+            area->updateSize();
+          }
+        }
+
+        if ((area->isDetached() || area->isFloating()) && area->windows().empty())
+          deleteArea(area);
+      }
+    }
+
+    // add windows and pages to restored areas
+    QSet<CQPaletteAreaPage *> placed;
+
+    for (const auto &areaState : areaStates) {
+      // floating area was being dragged so restore as detached
+      bool detached = (areaState.flags & (Detached | Floating));
+
+      CQPaletteArea *area = nullptr;
+      QList<int>     sizes;
+
+      for (const auto &windowState : areaState.windows) {
+        CQPaletteWindow *window = nullptr;
+
+        auto addWindow = [&]() {
+          if (! area)
+            area = (detached ? createArea(areaState.dockArea) : getArea(areaState.dockArea));
+
+          if (! window)
+            window = area->addWindow();
+        };
+
+        // add saved current page first so only its (lazy) widget is created
+        CQPaletteAreaPage *currentPage = nullptr;
+
+        if (windowState.current >= 0 && windowState.current < int(windowState.pages.size())) {
+          const LayoutState::Page &pageState = windowState.pages[uint(windowState.current)];
+
+          CQPaletteAreaPage *page = lookupPage(pageState.name);
+
+          if (page && ! pageState.hidden && ! placed.contains(page)) {
+            addWindow();
+
+            window->addPage(page);
+
+            placed.insert(page);
+
+            currentPage = page;
+          }
+        }
+
+        // insert other visible pages around current and add hidden pages without tabs
+        int pos = 0;
+
+        for (uint i = 0; i < windowState.pages.size(); ++i) {
+          const LayoutState::Page &pageState = windowState.pages[i];
+
+          CQPaletteAreaPage *page = lookupPage(pageState.name);
+
+          if (page && page == currentPage) {
+            ++pos;
+            continue;
+          }
+
+          if (! page || placed.contains(page))
+            continue;
+
+          addWindow();
+
+          if (pageState.hidden)
+            window->group()->addHiddenPage(page);
+          else
+            window->insertPage(pos++, page);
+
+          placed.insert(page);
+        }
+
+        if (! window)
+          continue;
+
+        if (! window->group()->numPages())
+          window->setVisible(false);
+
+        sizes.push_back(windowState.size);
+      }
+
+      if (! area)
+        continue;
+
+      if (detached) {
+        area->setDetached(true);
+
+        area->move  (areaState.rect.topLeft());
+        area->resize(areaState.rect.size());
+      }
+
+      // applied by deferred splitter and size updates
+      area->restoreSizes_ = sizes;
+      area->restoreSize_  = areaState.dockSize;
+
+      area->updateSplitterSizes();
+      area->updateSize();
+
+      restoreAreas.push_back(std::make_pair(area, &areaState));
+    }
+  }
+
+  //---
+
+  // expanded/pinned state (after restored sizes are applied)
+  UpdateGuard guard(this);
+
+  for (const auto &restoreArea : restoreAreas)
+    LayoutState::applyAreaState(restoreArea.first, *restoreArea.second);
+
+  return true;
+}
+
+bool
+CQPaletteAreaMgr::
+applyLayout(const QByteArray &state, const Pages &pages)
+{
+  using namespace LayoutState;
+
+  LayoutState::Areas areaStates;
+
+  if (! LayoutState::read(state, areaStates))
+    return false;
+
+  //---
+
+  LayoutState::PageMap namePages = LayoutState::pageMap(pages);
+
+  // resolved target window (pages found by name, each page used once)
+  struct TargetWindow {
+    const LayoutState::Window                        *state   { nullptr };
+    std::vector<std::pair<CQPaletteAreaPage *, bool>> pages;  // page and hidden
+    CQPaletteAreaPage                                *current { nullptr };
+  };
+
+  typedef std::vector<TargetWindow> TargetWindows;
+
+  std::vector<TargetWindows> targets(areaStates.size());
+
+  QSet<CQPaletteAreaPage *> placed;
+
+  for (uint i = 0; i < areaStates.size(); ++i) {
+    for (const auto &windowState : areaStates[i].windows) {
+      TargetWindow target;
+
+      target.state = &windowState;
+
+      for (uint j = 0; j < windowState.pages.size(); ++j) {
+        const LayoutState::Page &pageState = windowState.pages[j];
+
+        CQPaletteAreaPage *page = namePages.value(pageState.name, nullptr);
+
+        if (! page || placed.contains(page))
+          continue;
+
+        target.pages.push_back(std::make_pair(page, pageState.hidden));
+
+        if (int(j) == windowState.current)
+          target.current = page;
+
+        placed.insert(page);
+      }
+
+      if (! target.pages.empty())
+        targets[i].push_back(target);
+    }
+  }
+
+  //---
+
+  // current window of page (if any)
+  auto pageWindow = [](CQPaletteAreaPage *page) {
+    return (page->group() ? page->group()->window() : nullptr);
+  };
+
+  // get tab position of visible page in group (-1 if hidden or not in group)
+  auto tabPos = [](CQPaletteGroup *group, CQPaletteAreaPage *page) {
+    return (page->group() == group ? group->pageIndex(page) : -1);
+  };
+
+  LayoutState::AreaStates applyAreas;
+
+  {
+    // apply changes with a single splitter/title/size update per area
+    UpdateGuard guard(this);
+
+    QSet<CQPaletteArea *>   usedAreas;
+    QSet<CQPaletteWindow *> usedWindows;
+
+    for (uint i = 0; i < areaStates.size(); ++i) {
+      const LayoutState::Area &areaState = areaStates[i];
+      const TargetWindows     &windows   = targets[i];
+
+      if (windows.empty())
+        continue;
+
+      // floating area was being dragged so apply as detached
+      bool detached = (areaState.flags & (Detached | Floating));
+
+      //---
+
+      // get area (reuse detached area holding first page on same side)
+      CQPaletteArea *area = nullptr;
+
+      if (detached) {
+        CQPaletteWindow *window1 = pageWindow(windows[0].pages[0].first);
+        CQPaletteArea   *area1   = (window1 ? window1->area() : nullptr);
+
+        if (area1 && area1->isDetached() && area1->dockArea() == areaState.dockArea &&
+            ! usedAreas.contains(area1))
+          area = area1;
+        else
+          area = createArea(areaState.dockArea);
+      }
+      else
+        area = getArea(areaState.dockArea);
+
+      usedAreas.insert(area);
+
+      //---
+
+      CQPaletteArea::Windows areaWindows;
+      QList<int>             sizes;
+
+      for (const auto &target : windows) {
+        // reuse unused window holding most target pages
+        std::map<CQPaletteWindow *, int> counts;
+
+        for (const auto &pageHidden : target.pages) {
+          CQPaletteWindow *window1 = pageWindow(pageHidden.first);
+
+          if (window1 && ! usedWindows.contains(window1))
+            ++counts[window1];
+        }
+
+        CQPaletteWindow *window = nullptr;
+        int              count  = 0;
+
+        for (const auto &pc : counts) {
+          if (pc.second > count) {
+            window = pc.first;
+            count  = pc.second;
+          }
+        }
+
+        // move reused window to area (dock edge change) or create new window
+        if      (! window)
+          window = area->addWindow();
+        else if (window->area() != area) {
+          window->area()->removeWindow(window);
+
+          area->addWindow(window);
+        }
+
+        usedWindows.insert(window);
+
+        //---
+
+        // move pages which are not already at target tab position
+        CQPaletteGroup *group = window->group();
+
+        int pos = 0;
+
+        for (const auto &pageHidden : target.pages) {
+          CQPaletteAreaPage *page   = pageHidden.first;
+          bool               hidden = pageHidden.second;
+
+          if (! hidden) {
+            if (tabPos(group, page) != pos) {
+              if (page->group())
+                page->group()->removePage(page);
+
+              group->insertPage(pos, page);
+            }
+
+            ++pos;
+          }
+          else {
+            if (page->group() != group) {
+              if (page->group())
+                page->group()->removePage(page);
+
+              group->addPage(page);
+            }
+
+            if (! page->hidden())
+              group->hidePage(page);
+          }
+        }
+
+        CQPaletteAreaPage *current = target.current;
+
+        if (current && ! current->hidden() && current != group->currentPage())
+          group->setCurrentPage(current);
+
+        bool visible = (group->numPages() > 0);
+
+        // explicit state (isVisible is false for hidden ancestor)
+        if (window->isHidden() == visible)
+          window->setVisible(visible);
+
+        areaWindows.push_back(window);
+        sizes      .push_back(target.state->size);
+      }
+
+      //---
+
+      // reorder splitter windows (only moved windows are reinserted)
+      QSplitter *splitter = area->splitter()->splitter();
+
+      for (int j = 0; j < int(areaWindows.size()); ++j) {
+        if (splitter->indexOf(areaWindows[uint(j)]) != j)
+          splitter->insertWidget(j, areaWindows[uint(j)]);
+      }
+
+      //---
+
+      if (detached) {
+        if (! area->isDetached())
+          area->setDetached(true);
+
+        if (area->geometry() != areaState.rect) {
+          area->move  (areaState.rect.topLeft());
+          area->resize(areaState.rect.size());
+        }
+      }
+
+      // only resize if sizes changed
+      if (splitter->sizes() != sizes) {
+        area->restoreSizes_ = sizes;
+
+        area->updateSplitterSizes();
+      }
+
+      int dockSize = (area->isVerticalDockArea() ? area->dockWidth() : area->dockHeight());
+
+      if (dockSize != areaState.dockSize) {
+        area->restoreSize_ = areaState.dockSize;
+
+        area->updateSize();
+      }
+
+      applyAreas.push_back(std::make_pair(area, &areaState));
+    }
+
+    //---
+
+    // remove unused windows emptied by moves (join), hide windows with only hidden pages
+    for (Palettes::iterator p = palettes_.begin(); p != palettes_.end(); ++p) {
+      Areas areas = (*p).second;
+
+      for (auto *area : areas) {
+        CQPaletteArea::Windows windows = area->windows();
+
+        for (auto *window : windows) {
+          if (usedWindows.contains(window))
+            continue;
+
+          CQPaletteGroup::PageArray pages;
+
+          window->group()->getAllPages(pages);
+
+          if      (pages.empty()) {
+            area->removeWindow(window);
+
+            window->deleteLater();
+          }
+          else if (! window->isHidden() && ! window->group()->numPages()) {
+            window->setVisible(false);
+
+            area->updateSize();
+          }
+        }
+
+        if ((area->isDetached() || area->isFloating()) && area->windows().empty())
+          deleteArea(area);
+      }
+    }
+  }
+
+  //---
+
+  UpdateGuard guard(this);
+
+  for (const auto &applyArea : applyAreas)
+    LayoutState::applyAreaState(applyArea.first, *applyArea.second);
+
+  return true;
+}
@@ -0,0 +1,90 @@
+#include <CQPaletteDragGhost.h>
+
+#include <QPainter>
+
+CQPaletteDragGhost::
+CQPaletteDragGhost() :
+ QWidget(nullptr, Qt::ToolTip | Qt::FramelessWindowHint)
+{
+  setObjectName("dragGhost");
+
+  setAttribute(Qt::WA_TranslucentBackground);
+  setAttribute(Qt::WA_TransparentForMouseEvents);
+  setAttribute(Qt::WA_ShowWithoutActivating);
+  setAttribute(Qt::WA_NoSystemBackground);
+
+  setFocusPolicy(Qt::NoFocus);
+}
+
+void
+CQPaletteDragGhost::
+start(QWidget *w)
+{
+  // grab once, only the snapshot is moved while dragging
+  pixmap_ = w->grab();
+
+  setGeometry(QRect(w->mapToGlobal(QPoint(0, 0)), w->size()));
+
+  show();
+
+  raise();
+}
+
+void
+CQPaletteDragGhost::
+start(QWidget *w, QWidget *tabbar, const QRect &tabRect)
+{
+  QRect wrect(w->mapToGlobal(QPoint(0, 0)), w->size());
+  QRect trect(tabbar->mapToGlobal(tabRect.topLeft()), tabRect.size());
+
+  QRect rect = wrect.united(trect);
+
+  // combine snapshots at their relative positions
+  qreal dpr = w->devicePixelRatioF();
+
+  pixmap_ = QPixmap(rect.size()*dpr);
+
+  pixmap_.setDevicePixelRatio(dpr);
+
+  pixmap_.fill(Qt::transparent);
+
+  QPainter painter(&pixmap_);
+
+  painter.drawPixmap(wrect.topLeft() - rect.topLeft(), w->grab());
+  painter.drawPixmap(trect.topLeft() - rect.topLeft(), tabbar->grab(tabRect));
+
+  painter.end();
+
+  setGeometry(rect);
+
+  show();
+
+  raise();
+}
+
+void
+CQPaletteDragGhost::
+moveBy(const QPoint &d)
+{
+  move(pos() + d);
+}
+
+void
+CQPaletteDragGhost::
+stop()
+{
+  hide();
+
+  pixmap_ = QPixmap();
+}
+
+void
+CQPaletteDragGhost::
+paintEvent(QPaintEvent *)
+{
+  QPainter painter(this);
+
+  painter.setOpacity(opacity_);
+
+  painter.drawPixmap(rect(), pixmap_);
+}
@@ -0,0 +1,88 @@
+#include <CQPaletteDropIndicator.h>
+
+#include <QPainter>
+#include <QEvent>
+
+CQPaletteDropIndicator::
+CQPaletteDropIndicator(QWidget *parent) :
+ QWidget(parent)
+{
+  setObjectName("dropIndicator");
+
+  setAttribute(Qt::WA_TransparentForMouseEvents);
+  setAttribute(Qt::WA_NoSystemBackground);
+
+  setFocusPolicy(Qt::NoFocus);
+
+  hide();
+}
+
+void
+CQPaletteDropIndicator::
+setGlobalRect(const QRect &rect)
+{
+  QRect lrect(parentWidget()->mapFromGlobal(rect.topLeft()), rect.size());
+
+  // child geometry change only repaints old and new rects
+  if (lrect != geometry())
+    setGeometry(lrect);
+
+  if (! isVisible()) {
+    show();
+
+    raise();
+  }
+}
+
+void
+CQPaletteDropIndicator::
+paintEvent(QPaintEvent *)
+{
+  QPainter painter(this);
+
+  QRect r = rect();
+
+  painter.fillRect(r, fillBrush());
+
+  painter.setPen(color_);
+  painter.setBrush(Qt::NoBrush);
+
+  painter.drawRect(r.adjusted(0, 0, -1, -1));
+
+  if (innerBorder_)
+    painter.drawRect(r.adjusted(3, 3, -4, -4));
+}
+
+void
+CQPaletteDropIndicator::
+changeEvent(QEvent *e)
+{
+  if (e->type() == QEvent::PaletteChange)
+    brushValid_ = false;
+
+  QWidget::changeEvent(e);
+}
+
+const QBrush &
+CQPaletteDropIndicator::
+fillBrush()
+{
+  // same dense pattern as CQRubberBand, built once per palette
+  if (! brushValid_) {
+    QPixmap tiledPixmap(16, 16);
+
+    QPainter pixmapPainter(&tiledPixmap);
+
+    pixmapPainter.setPen(Qt::NoPen);
+    pixmapPainter.setBrush(Qt::Dense4Pattern);
+    pixmapPainter.setBackground(palette().base());
+    pixmapPainter.setBackgroundMode(Qt::OpaqueMode);
+    pixmapPainter.drawRect(0, 0, tiledPixmap.width(), tiledPixmap.height());
+    pixmapPainter.end();
+
+    brush_      = QBrush(tiledPixmap);
+    brushValid_ = true;
+  }
+
+  return brush_;
+}
@@ -2,6 +2,10 @@
 #include <CQPaletteArea.h>
 #include <CQWidgetUtil.h>
 #include <QVariant>
+#include <QEvent>
+#include <QTimer>
+#include <QSignalBlocker>
+#include <algorithm>
 #include <cassert>
 
 CQPaletteGroupMgr *
@@ -29,6 +33,8 @@ createGroup(CQPaletteWindow *window)
 
   groups_.push_back(group);
 
+  tabBarGroups_[group->tabbar()->id()] = group;
+
   return group;
 }
 
@@ -36,18 +42,13 @@ void
 CQPaletteGroupMgr::
 removeGroup(CQPaletteGroup *group)
 {
-  uint i = 0;
-
-  for ( ; i < groups_.size(); ++i)
-    if (groups_[i] == group)
-      break;
+  auto p = std::find(groups_.begin(), groups_.end(), group);
 
-  assert(i < groups_.size());
+  assert(p != groups_.end());
 
-  for ( ; i < groups_.size(); ++i)
-    groups_[i] = groups_[i + 1];
+  groups_.erase(p);
 
-  groups_.pop_back();
+  tabBarGroups_.remove(group->tabbar()->id());
 }
 
 CQPaletteGroup *
@@ -63,13 +64,9 @@ getGroup(const QString &name) const
 
 CQPaletteGroup *
 CQPaletteGroupMgr::
-getGroupFromTabBar(const QString &name) const
+getGroupFromTabBarId(uint id) const
 {
-  for (uint i = 0; i < groups_.size(); ++i)
-    if (groups_[i]->tabbar()->objectName() == name)
-      return groups_[i];
-
-  return nullptr;
+  return tabBarGroups_.value(id, nullptr);
 }
 
 //-------
@@ -85,11 +82,16 @@ CQPaletteGroup(CQPaletteWindow *window) :
   tabbar_ = new CQPaletteGroupTabBar(this);
   stack_  = new CQPaletteGroupStack (this);
 
+  // page widget size constraint changes post layout request to stack
+  stack_->installEventFilter(this);
+
   connect(tabbar_, SIGNAL(currentChanged(int)), this, SLOT(setTabIndex(int)));
   connect(tabbar_, SIGNAL(currentPressed(int)), this, SLOT(pressTabIndex(int)));
 
-  connect(tabbar_, SIGNAL(tabMovePageSignal(const QString &, int, const QString &, int)),
-          this, SLOT(tabMovePageSlot(const QString &, int, const QString &, int)));
+  connect(tabbar_, SIGNAL(tabMovePageSignal(uint, int, uint, int)),
+          this, SLOT(tabMovePageSlot(uint, int, uint, int)));
+
+  connect(tabbar_, SIGNAL(tabMoved(int, int)), this, SLOT(tabMovedSlot(int, int)));
 
   updateLayout();
 }
@@ -131,10 +133,19 @@ addPage(CQPaletteAreaPage *page)
 
   pages_[page->id()] = page;
 
+  page->stopDiscardTimer();
+
   page->setHidden(false);
 
-  tabbar_->addPage(page);
-  stack_ ->addPage(page);
+  int tabInd = tabbar_->addPage(page);
+
+  addVisiblePage(int(visiblePages_.size()), page, tabInd);
+
+  stack_->addPage(page);
+
+  // first tab is made current before page is registered (create lazy widget)
+  if (tabInd == tabbar_->currentIndex())
+    stack_->setPage(page);
 }
 
 void
@@ -147,8 +158,19 @@ insertPage(int ind, CQPaletteAreaPage *page)
 
   pages_[page->id()] = page;
 
-  tabbar_->insertPage(ind, page);
-  stack_ ->addPage   (page);
+  page->stopDiscardTimer();
+
+  page->setHidden(false);
+
+  int tabInd = tabbar_->insertPage(ind, page);
+
+  addVisiblePage(std::min(std::max(ind, 0), int(visiblePages_.size())), page, tabInd);
+
+  stack_->addPage(page);
+
+  // create lazy widget of new current tab (see addPage)
+  if (tabInd == tabbar_->currentIndex())
+    stack_->setPage(page);
 }
 
 void
@@ -157,10 +179,13 @@ removePage(CQPaletteAreaPage *page)
 {
   page->setGroup(nullptr);
 
-  page->setHidden(true);
+  if (! page->hidden()) {
+    removeVisiblePage(page);
+
+    stack_->removePage(page);
+  }
 
-  tabbar_->removePage(page);
-  stack_ ->removePage(page);
+  page->setHidden(true);
 
   pages_.erase(page->id());
 
@@ -168,6 +193,21 @@ removePage(CQPaletteAreaPage *page)
     setCurrentPage(pages_.begin()->second);
 }
 
+void
+CQPaletteGroup::
+addHiddenPage(CQPaletteAreaPage *page)
+{
+  page->setGroup(this);
+
+  page->setDockArea(dockArea());
+
+  pages_[page->id()] = page;
+
+  page->setHidden(true);
+
+  page->startDiscardTimer();
+}
+
 void
 CQPaletteGroup::
 showPage(CQPaletteAreaPage *page)
@@ -175,10 +215,19 @@ showPage(CQPaletteAreaPage *page)
   if (! page->hidden())
     return;
 
+  page->stopDiscardTimer();
+
   page->setHidden(false);
 
-  tabbar_->addPage(page);
-  stack_ ->addPage(page);
+  int tabInd = tabbar_->addPage(page);
+
+  addVisiblePage(int(visiblePages_.size()), page, tabInd);
+
+  stack_->addPage(page);
+
+  // create lazy widget of new current tab (see addPage)
+  if (tabInd == tabbar_->currentIndex())
+    stack_->setPage(page);
 
   if (! currentPage())
     setCurrentPage(page);
@@ -195,13 +244,77 @@ hidePage(CQPaletteAreaPage *page)
 
   page->setHidden(true);
 
-  tabbar_->removePage(page);
-  stack_ ->removePage(page);
+  removeVisiblePage(page);
+
+  stack_->removePage(page);
+
+  page->startDiscardTimer();
 
   if (current)
     updateCurrentPage();
 }
 
+void
+CQPaletteGroup::
+movePages(const PageArray &pages, CQPaletteGroup *newGroup, CQPaletteAreaPage *current)
+{
+  assert(newGroup != this);
+
+  if (pages.empty())
+    return;
+
+  {
+    // no current page changes or tab bar relayout per page
+    QSignalBlocker blocker1(tabbar_);
+    QSignalBlocker blocker2(newGroup->tabbar_);
+
+    tabbar_          ->beginUpdate();
+    newGroup->tabbar_->beginUpdate();
+
+    for (auto *page : pages) {
+      assert(page->group() == this);
+
+      // hidden pages stay hidden (not in tab bar or stack)
+      bool hidden = page->hidden();
+
+      if (! hidden) {
+        removeVisiblePage(page);
+
+        stack_->removePage(page);
+      }
+
+      pages_.erase(page->id());
+
+      page->setGroup(newGroup);
+
+      page->setDockArea(newGroup->dockArea());
+
+      newGroup->pages_[page->id()] = page;
+
+      if (! hidden) {
+        int tabInd = newGroup->tabbar_->addPage(page);
+
+        newGroup->addVisiblePage(int(newGroup->visiblePages_.size()), page, tabInd);
+
+        newGroup->stack_->addPage(page);
+      }
+    }
+
+    tabbar_          ->endUpdate();
+    newGroup->tabbar_->endUpdate();
+
+    if (current && newGroup->pageTabs_.contains(current->id()))
+      newGroup->tabbar_->setCurrentIndex(newGroup->pageTabs_.value(current->id()));
+  }
+
+  // single stack update and current page signal for new group
+  newGroup->setTabIndex(newGroup->tabbar_->currentIndex());
+
+  // current page of this group may have been moved
+  if (! currentPage())
+    updateCurrentPage();
+}
+
 CQPaletteAreaPage *
 CQPaletteGroup::
 currentPage() const
@@ -225,69 +338,79 @@ void
 CQPaletteGroup::
 setCurrentPage(CQPaletteAreaPage *page)
 {
-  for (int i = 0; i < tabbar_->count(); ++i) {
-    int ind = tabbar_->tabInd(i);
+  auto p = pageTabs_.find(page->id());
 
-    uint id = tabbar_->getPageId(ind);
+  if (p == pageTabs_.end())
+    return;
 
-    if (id == page->id()) {
-      tabbar_->setCurrentIndex(ind);
+  tabbar_->setCurrentIndex(p.value());
 
-      return;
-    }
-  }
+  // already current tab with lazy widget not yet created
+  if (! page->hasWidget())
+    stack_->setPage(page);
 }
 
 void
 CQPaletteGroup::
 updateCurrentPage()
 {
-  for (Pages::const_iterator p = pages_.begin(); p != pages_.end(); ++p) {
-    CQPaletteAreaPage *page = (*p).second;
-
-    if (! page->hidden()) {
-      setCurrentPage(page);
-      return;
-    }
-  }
+  if (! visiblePages_.empty())
+    setCurrentPage(visiblePages_.front());
 }
 
 CQPaletteAreaPage *
 CQPaletteGroup::
 getPage(int i) const
 {
-  PageArray pages;
-
-  getPages(pages);
-
-  return pages[uint(i)];
+  return visiblePages_[uint(i)];
 }
 
 uint
 CQPaletteGroup::
 numPages() const
 {
-  uint num = 0;
+  return uint(visiblePages_.size());
+}
+
+void
+CQPaletteGroup::
+getPages(PageArray &pages) const
+{
+  pages.insert(pages.end(), visiblePages_.begin(), visiblePages_.end());
+}
+
+int
+CQPaletteGroup::
+pageIndex(CQPaletteAreaPage *page) const
+{
+  return pagePos_.value(page->id(), -1);
+}
+
+void
+CQPaletteGroup::
+getAllPages(PageArray &pages) const
+{
+  // visible pages in tab order
+  getPages(pages);
 
+  // hidden pages (not in tab bar)
   for (Pages::const_iterator p = pages_.begin(); p != pages_.end(); ++p) {
     CQPaletteAreaPage *page = (*p).second;
 
-    if (! page->hidden())
-      ++num;
+    if (page->hidden())
+      pages.push_back(page);
   }
-
-  return num;
 }
 
 void
 CQPaletteGroup::
-getPages(PageArray &pages) const
+discardHiddenPages()
 {
   for (Pages::const_iterator p = pages_.begin(); p != pages_.end(); ++p) {
     CQPaletteAreaPage *page = (*p).second;
 
-    if (! page->hidden())
-      pages.push_back(page);
+    if (page->hidden())
+      (void) page->discardWidget();
   }
 }
 
@@ -315,32 +438,116 @@ pressTabIndex(int /*ind*/)
 
 void
 CQPaletteGroup::
-tabMovePageSlot(const QString &fromName, int fromIndex, const QString &toName, int /*toIndex*/)
+tabMovePageSlot(uint fromTabBarId, int fromIndex, uint toTabBarId, int /*toIndex*/)
 {
-  CQPaletteGroup *group1 = CQPaletteGroupMgrInst->getGroupFromTabBar(fromName);
-  CQPaletteGroup *group2 = CQPaletteGroupMgrInst->getGroupFromTabBar(toName);
+  CQPaletteGroup *group1 = CQPaletteGroupMgrInst->getGroupFromTabBarId(fromTabBarId);
+  CQPaletteGroup *group2 = CQPaletteGroupMgrInst->getGroupFromTabBarId(toTabBarId);
 
   assert(group2 == this);
 
+  // source tab bar may not be a palette group tab bar
+  if (! group1) return;
+
   CQPaletteAreaPage *page1 = group1->getPageForIndex(fromIndex);
+  if (! page1) return;
 //CQPaletteAreaPage *page2 = group2->getPageForIndex(toIndex);
 
   if (page1->allowedAreas() & group2->window()->dockArea())
     group1->window()->movePage(page1, group2->window());
 }
 
+void
+CQPaletteGroup::
+tabMovedSlot(int, int)
+{
+  updateVisiblePages();
+}
+
 CQPaletteAreaPage *
 CQPaletteGroup::
 getPageForIndex(int ind) const
 {
-  uint id = tabbar_->getPageId(ind);
+  return tabPages_.value(ind, nullptr);
+}
 
-  Pages::const_iterator p = pages_.find(id);
+void
+CQPaletteGroup::
+addVisiblePage(int pos, CQPaletteAreaPage *page, int ind)
+{
+  visiblePages_.insert(visiblePages_.begin() + pos, page);
 
-  if (p == pages_.end())
-    return nullptr;
+  pageTabs_[page->id()] = ind;
+  tabPages_[ind]        = page;
 
-  return (*p).second;
+  updatePagePos(pos);
+}
+
+void
+CQPaletteGroup::
+removeVisiblePage(CQPaletteAreaPage *page)
+{
+  int pos = pagePos_.value(page->id(), -1);
+  assert(pos >= 0);
+
+  int ind = pageTabs_.value(page->id());
+
+  visiblePages_.erase(visiblePages_.begin() + pos);
+
+  pagePos_ .remove(page->id());
+  pageTabs_.remove(page->id());
+  tabPages_.remove(ind);
+
+  tabbar_->removeTab(ind);
+
+  updatePagePos(pos);
+}
+
+void
+CQPaletteGroup::
+updatePagePos(int pos)
+{
+  for (int i = pos; i < int(visiblePages_.size()); ++i)
+    pagePos_[visiblePages_[uint(i)]->id()] = i;
+}
+
+void
+CQPaletteGroup::
+updateVisiblePages()
+{
+  // tab move swaps tab data so rebuild from page ids in tab data
+  visiblePages_.clear();
+
+  pagePos_ .clear();
+  pageTabs_.clear();
+  tabPages_.clear();
+
+  for (int i = 0; i < tabbar_->count(); ++i) {
+    int ind = tabbar_->tabInd(i);
+
+    Pages::const_iterator p = pages_.find(tabbar_->getPageId(ind));
+    if (p == pages_.end()) continue;
+
+    CQPaletteAreaPage *page = (*p).second;
+
+    visiblePages_.push_back(page);
+
+    pageTabs_[page->id()] = ind;
+    tabPages_[ind]        = page;
+  }
+
+  updatePagePos(0);
+}
+
+bool
+CQPaletteGroup::
+eventFilter(QObject *obj, QEvent *e)
+{
+  if (obj == stack_ && e->type() == QEvent::LayoutRequest) {
+    for (const auto &p : pages_)
+      p.second->invalidateSizeCache();
+  }
+
+  return QWidget::eventFilter(obj, e);
 }
 
 void
@@ -462,40 +669,26 @@ updateDockArea()
 #endif
 }
 
-void
+int
 CQPaletteGroupTabBar::
 addPage(CQPaletteAreaPage *page)
 {
   int ind = addTab(page->icon(), page->title());
 
   setTabData(ind, page->id());
+
+  return ind;
 }
 
-void
+int
 CQPaletteGroupTabBar::
 insertPage(int ind, CQPaletteAreaPage *page)
 {
   int ind1 = insertTab(ind, page->icon(), page->title());
 
   setTabData(ind1, page->id());
-}
-
-void
-CQPaletteGroupTabBar::
-removePage(CQPaletteAreaPage *page)
-{
-  int i = 0, ind = -1;
-
-  for ( ; i < count(); ++i) {
-    ind = tabInd(i);
-
-    if (getPageId(ind) == page->id())
-      break;
-  }
-
-  assert(i < count());
 
-  removeTab(ind);
+  return ind1;
 }
 
 uint
@@ -560,28 +753,41 @@ void
 CQPaletteGroupStack::
 addPage(CQPaletteAreaPage *page)
 {
+  // lazy page widget is added when page is first made current
+  QWidget *w = page->widget();
+  if (! w) return;
+
   QWidget *pw = parentWidget();
-  QWidget *cw = page->widget()->parentWidget();
+  QWidget *cw = w->parentWidget();
 
   assert(pw != cw);
 
-  addWidget(page->widget());
+  addWidget(w);
 }
 
 void
 CQPaletteGroupStack::
 removePage(CQPaletteAreaPage *page)
 {
-  removeWidget(page->widget());
+  QWidget *w = page->widget();
+  if (! w) return;
+
+  removeWidget(w);
 
-  page->widget()->setParent(nullptr);
+  w->setParent(nullptr);
 }
 
 void
 CQPaletteGroupStack::
 setPage(CQPaletteAreaPage *page)
 {
-  setCurrentWidget(page->widget());
+  QWidget *w = page->ensureWidget();
+  if (! w) return;
+
+  if (indexOf(w) < 0)
+    addWidget(w);
+
+  setCurrentWidget(w);
 }
 
 //------
@@ -591,18 +797,165 @@ uint CQPaletteAreaPage::lastId_ = 0;
 CQPaletteAreaPage::
 CQPaletteAreaPage(QWidget *w) :
  w_(w), dockArea_(Qt::NoDockWidgetArea), hidden_(false), fixedWidth_(100), fixedHeight_(100),
- widthResizable_(true), heightResizable_(true)
+ widthResizable_(true), heightResizable_(true), sizeValid_(false), discardTimeout_(-1),
+ discardTimer_(nullptr)
 {
   setObjectName("page");
 
   id_ = ++lastId_;
+
+  // watch layout requests to invalidate cached min/max size
+  if (w_)
+    w_->installEventFilter(this);
+}
+
+CQPaletteAreaPage::
+CQPaletteAreaPage(const WidgetFactory &factory) :
+ CQPaletteAreaPage(static_cast<QWidget *>(nullptr))
+{
+  factory_ = factory;
 }
 
 void
 CQPaletteAreaPage::
 setWidget(QWidget *w)
 {
+  if (w_)
+    w_->removeEventFilter(this);
+
   w_ = w;
+
+  if (w_)
+    w_->installEventFilter(this);
+
+  invalidateSizeCache();
+}
+
+QWidget *
+CQPaletteAreaPage::
+ensureWidget()
+{
+  if (! w_) {
+    QWidget *w = createWidget();
+
+    if (w) {
+      setWidget(w);
+
+      // restore state of discarded widget
+      if (savedState_.isValid()) {
+        restoreState(savedState_);
+
+        savedState_ = QVariant();
+      }
+    }
+  }
+
+  return w_;
+}
+
+void
+CQPaletteAreaPage::
+setDiscardTimeout(int secs)
+{
+  discardTimeout_ = secs;
+
+  if (discardTimeout_ <= 0)
+    stopDiscardTimer();
+}
+
+bool
+CQPaletteAreaPage::
+discardWidget()
+{
+  // widget must be recreatable (factory or createWidget override)
+  if (! w_ || ! hidden() || ! isDiscardable())
+    return false;
+
+  stopDiscardTimer();
+
+  savedState_ = saveState();
+
+  QWidget *w = w_;
+
+  setWidget(nullptr);
+
+  delete w;
+
+  return true;
+}
+
+void
+CQPaletteAreaPage::
+startDiscardTimer()
+{
+  if (discardTimeout_ <= 0 || ! w_ || ! canRecreateWidget())
+    return;
+
+  if (! discardTimer_) {
+    discardTimer_ = new QTimer(this);
+
+    discardTimer_->setObjectName("discardTimer");
+    discardTimer_->setSingleShot(true);
+
+    connect(discardTimer_, SIGNAL(timeout()), this, SLOT(discardTimerSlot()));
+  }
+
+  discardTimer_->start(1000*discardTimeout_);
+}
+
+void
+CQPaletteAreaPage::
+stopDiscardTimer()
+{
+  if (discardTimer_)
+    discardTimer_->stop();
+}
+
+void
+CQPaletteAreaPage::
+discardTimerSlot()
+{
+  (void) discardWidget();
+}
+
+QWidget *
+CQPaletteAreaPage::
+createWidget()
+{
+  return (factory_ ? factory_() : nullptr);
+}
+
+bool
+CQPaletteAreaPage::
+eventFilter(QObject *obj, QEvent *e)
+{
+  if (obj == w_ && e->type() == QEvent::LayoutRequest)
+    invalidateSizeCache();
+
+  return QObject::eventFilter(obj, e);
+}
+
+void
+CQPaletteAreaPage::
+updateSizeCache() const
+{
+  if (sizeValid_)
+    return;
+
+  QWidget *w = const_cast<CQPaletteAreaPage *>(this)->widget();
+
+  // placeholder size until widget is created
+  if (! w) {
+    minSize_ = placeholderSize();
+    maxSize_ = QSize(QWIDGETSIZE_MAX, QWIDGETSIZE_MAX);
+
+    return;
+  }
+
+  minSize_ = CQWidgetUtil::SmartMinSize(w);
+  maxSize_ = w->maximumSize();
+
+  sizeValid_ = true;
 }
 
 // get page min/max width
@@ -611,12 +964,10 @@ CQPaletteAreaPage::
 getMinMaxWidth(int &min_w, int &max_w) const
 {
   if (widthResizable()) {
-    QWidget *w = const_cast<CQPaletteAreaPage *>(this)->widget();
-
-    QSize s = CQWidgetUtil::SmartMinSize(w);
+    updateSizeCache();
 
-    min_w = s.width();
-    max_w = w->maximumWidth();
+    min_w = minSize_.width();
+    max_w = maxSize_.width();
   }
   else {
     min_w = fixedWidth_;
@@ -630,12 +981,10 @@ CQPaletteAreaPage::
 getMinMaxHeight(int &min_h, int &max_h) const
 {
   if (heightResizable()) {
-    QWidget *w = const_cast<CQPaletteAreaPage *>(this)->widget();
-
-    QSize s = CQWidgetUtil::SmartMinSize(w);
+    updateSizeCache();
 
-    min_h = s.height();
-    max_h = w->maximumHeight();
+    min_h = minSize_.height();
+    max_h = maxSize_.height();
   }
   else {
     min_h = fixedHeight_;
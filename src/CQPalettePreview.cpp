@@ -7,12 +7,85 @@
 #include <QSizeGrip>
 #include <QDialog>
 
+#include <algorithm>
+
+// single application event filter shared by all active previews
+//
+// only mouse press/release events are passed on (checked before any cast)
+class CQPalettePreviewFilter : public QObject {
+ public:
+  static CQPalettePreviewFilter *instance() {
+    static CQPalettePreviewFilter *filter;
+
+    if (! filter)
+      filter = new CQPalettePreviewFilter;
+
+    return filter;
+  }
+
+  void addPreview(CQPalettePreview *preview) {
+    if (previews_.empty())
+      qApp->installEventFilter(this);
+
+    previews_.push_back(preview);
+  }
+
+  void removePreview(CQPalettePreview *preview) {
+    auto p = std::find(previews_.begin(), previews_.end(), preview);
+
+    if (p != previews_.end())
+      previews_.erase(p);
+
+    if (previews_.empty())
+      qApp->removeEventFilter(this);
+  }
+
+ private:
+  bool eventFilter(QObject *obj, QEvent *event) override {
+    QEvent::Type type = event->type();
+
+    if (type != QEvent::MouseButtonPress && type != QEvent::MouseButtonDblClick &&
+        type != QEvent::MouseButtonRelease)
+      return false;
+
+    // ignore if not a widget
+    if (! obj->isWidgetType())
+      return false;
+
+    QWidget     *w  = static_cast<QWidget *>(obj);
+    QMouseEvent *me = static_cast<QMouseEvent *>(event);
+
+    // copy as stop preview can deactivate previews
+    Previews previews = previews_;
+
+    for (auto *preview : previews) {
+      if (! preview->processEvent(w, me))
+        emit preview->stopPreview();
+    }
+
+    return false;
+  }
+
+ private:
+  typedef std::vector<CQPalettePreview *> Previews;
+
+  Previews previews_;
+};
+
+//------
+
 CQPalettePreview::
 CQPalettePreview() :
  active_(false), stopOnRelease_(false)
 {
 }
 
+CQPalettePreview::
+~CQPalettePreview()
+{
+  setActive(false);
+}
+
 void
 CQPalettePreview::
 setActive(bool active)
@@ -23,17 +96,35 @@ setActive(bool active)
   active_ = active;
 
   if (active_)
-    qApp->installEventFilter(this);
+    CQPalettePreviewFilter::instance()->addPreview(this);
   else
-    qApp->removeEventFilter(this);
+    CQPalettePreviewFilter::instance()->removePreview(this);
 }
 
 void
 CQPalettePreview::
 clear()
 {
+  clearWidgets();
+  clearRects  ();
+}
+
+void
+CQPalettePreview::
+clearWidgets()
+{
+  for (auto *obj : members_)
+    disconnect(obj, SIGNAL(destroyed(QObject *)), this, SLOT(widgetDestroyedSlot(QObject *)));
+
   widgets_.clear();
-  rects_  .clear();
+  members_.clear();
+}
+
+void
+CQPalettePreview::
+clearRects()
+{
+  rects_.clear();
 }
 
 void
@@ -41,44 +132,49 @@ CQPalettePreview::
 addWidget(QWidget *w)
 {
   widgets_.insert(w);
+
+  // children are marked on first use (see isPreviewWidget)
+  addMember(w);
 }
 
 void
 CQPalettePreview::
-addRect(const QRect &r)
+addMember(QWidget *w) const
 {
-  rects_.push_back(r);
+  if (members_.contains(w))
+    return;
+
+  members_.insert(w);
+
+  // remove stale pointer (address may be reused by new widget)
+  connect(w, SIGNAL(destroyed(QObject *)), this, SLOT(widgetDestroyedSlot(QObject *)));
 }
 
-bool
+void
 CQPalettePreview::
-eventFilter(QObject *obj, QEvent *event)
+widgetDestroyedSlot(QObject *obj)
 {
-  bool ok = processEvent(obj, event);
-
-  if (! ok)
-    emit stopPreview();
+  widgets_.remove(obj);
+  members_.remove(obj);
+}
 
-  return QObject::eventFilter(obj, event);
+void
+CQPalettePreview::
+addRect(const QRect &r)
+{
+  rects_.push_back(r);
 }
 
 bool
 CQPalettePreview::
-processEvent(QObject *obj, QEvent *event)
+processEvent(QWidget *w, QMouseEvent *me)
 {
-  QEvent::Type type = event->type();
-
-  // ignore if not a widget
-  QWidget *w = qobject_cast<QWidget *>(obj);
-  if (! w) return true;
+  QEvent::Type type = me->type();
 
   bool previewValid = true;
 
-  // ignore if not a button event
   if      (type == QEvent::MouseButtonPress || type == QEvent::MouseButtonDblClick) {
     // stop preview if event is not in an allowable widget or rectangle
-    QMouseEvent *me = static_cast<QMouseEvent *>(event);
-
     stopOnRelease_ = false;
 
     if (type == QEvent::MouseButtonPress)
@@ -88,8 +184,6 @@ processEvent(QObject *obj, QEvent *event)
   }
   else if (type == QEvent::MouseButtonRelease) {
     // stop preview if event is not in an allowable widget or rectangle
-    QMouseEvent *me = static_cast<QMouseEvent *>(event);
-
     if (stopOnRelease_) {
       previewValid   = false;
       stopOnRelease_ = false;
@@ -97,13 +191,8 @@ processEvent(QObject *obj, QEvent *event)
     else
       previewValid = isPreviewValid(w, me->globalPos(), false);
   }
-  else
-    return true;
 
-  if (! previewValid)
-    return false;
-
-  return true;
+  return previewValid;
 }
 
 // check if mouse in an allowable widget or rectangle
@@ -173,22 +262,12 @@ bool
 CQPalettePreview::
 checkPreviewRects(const QPoint &gp, int tol) const
 {
-  bool found = false;
-
-  int n = rects_.size();
-
-  for (int i = 0; i < n; ++i) {
-    const QRect &r = rects_[i];
-
-    QRect r1 = r.adjusted(-tol, -tol, tol, tol);
-
-    if (r1.contains(gp)) {
-      found = true;
-      break;
-    }
+  for (const auto &r : rects_) {
+    if (r.adjusted(-tol, -tol, tol, tol).contains(gp))
+      return true;
   }
 
-  return found;
+  return false;
 }
 
 // check if widget is a preview widget or a child of it
@@ -196,11 +275,20 @@ bool
 CQPalettePreview::
 isPreviewWidget(QWidget *w) const
 {
-  QWidget *w1 = w;
+  if (! w)
+    return false;
+
+  if (members_.contains(w))
+    return true;
+
+  // child created after preview was updated so check parents and mark if found
+  QWidget *w1 = w->parentWidget();
 
   while (w1) {
-    if (widgets_.contains(w1))
+    if (members_.contains(w1)) {
+      addMember(w);
       return true;
+    }
 
     w1 = w1->parentWidget();
   }
@@ -213,16 +301,11 @@ bool
 CQPalettePreview::
 isModalDialogWidget(QWidget *w) const
 {
-  QWidget *w1 = w;
-
-  while (w1) {
-    QDialog *dialog = qobject_cast<QDialog *>(w1);
-
-    if (dialog && dialog->isModal())
-      return true;
+  if (! w)
+    return false;
 
-    w1 = w1->parentWidget();
-  }
+  // dialogs are top level so only check widget's window
+  QDialog *dialog = qobject_cast<QDialog *>(w->window());
 
-  return false;
+  return (dialog && dialog->isModal());
 }
@@ -23,16 +23,7 @@ class CQRubberBandStyle : public QCommonStyle {
       const QStyleOptionRubberBand *rbOpt = qstyleoption_cast<const QStyleOptionRubberBand *>(opt);
 
 #ifdef COMMON_STYLE
-      QPixmap tiledPixmap(16, 16);
-      QPainter pixmapPainter(&tiledPixmap);
-      pixmapPainter.setPen(Qt::NoPen);
-      pixmapPainter.setBrush(Qt::Dense4Pattern);
-      pixmapPainter.setBackground(QBrush(opt->palette.base()));
-      pixmapPainter.setBackgroundMode(Qt::OpaqueMode);
-      pixmapPainter.drawRect(0, 0, tiledPixmap.width(), tiledPixmap.height());
-      pixmapPainter.end();
-      // ### workaround for borked XRENDER
-      tiledPixmap = QPixmap::fromImage(tiledPixmap.toImage());
+      const QPixmap &tiledPixmap = this->tiledPixmap(opt->palette.base().color());
 
       p->save();
       QRect r = opt->rect;
@@ -49,16 +40,7 @@ class CQRubberBandStyle : public QCommonStyle {
       p->restore();
 #endif
 #ifdef MOTIF_STYLE
-      QPixmap tiledPixmap(16, 16);
-      QPainter pixmapPainter(&tiledPixmap);
-      pixmapPainter.setPen(Qt::NoPen);
-      pixmapPainter.setBrush(Qt::Dense4Pattern);
-      pixmapPainter.setBackground(QBrush(opt->palette.base()));
-      pixmapPainter.setBackgroundMode(Qt::OpaqueMode);
-      pixmapPainter.drawRect(0, 0, tiledPixmap.width(), tiledPixmap.height());
-      pixmapPainter.end();
-      // ### workaround for borked XRENDER
-      tiledPixmap = QPixmap::fromImage(tiledPixmap.toImage());
+      const QPixmap &tiledPixmap = this->tiledPixmap(opt->palette.base().color());
 
       p->save();
       QRect r = opt->rect;
@@ -78,15 +60,7 @@ class CQRubberBandStyle : public QCommonStyle {
       p->restore();
 #endif
 #ifdef WINDOWS_STYLE
-      QPixmap tiledPixmap(16, 16);
-      QPainter pixmapPainter(&tiledPixmap);
-      pixmapPainter.setPen(Qt::NoPen);
-      pixmapPainter.setBrush(Qt::Dense4Pattern);
-      pixmapPainter.setBackground(Qt::white);
-      pixmapPainter.setBackgroundMode(Qt::OpaqueMode);
-      pixmapPainter.drawRect(0, 0, tiledPixmap.width(), tiledPixmap.height());
-      pixmapPainter.end();
-      tiledPixmap = QPixmap::fromImage(tiledPixmap.toImage());
+      const QPixmap &tiledPixmap = this->tiledPixmap(Qt::white);
       p->save();
       QRect r = opt->rect;
       QStyleHintReturnMask mask;
@@ -114,9 +88,31 @@ class CQRubberBandStyle : public QCommonStyle {
       QCommonStyle::drawControl(element, opt, p, widget);
   }
 
+  // get dense pattern pixmap on background color (rebuilt only if color changes)
+  const QPixmap &tiledPixmap(const QColor &bg) const {
+    if (tiledPixmap_.isNull() || bg != tiledBg_) {
+      QPixmap tiledPixmap(16, 16);
+      QPainter pixmapPainter(&tiledPixmap);
+      pixmapPainter.setPen(Qt::NoPen);
+      pixmapPainter.setBrush(Qt::Dense4Pattern);
+      pixmapPainter.setBackground(QBrush(bg));
+      pixmapPainter.setBackgroundMode(Qt::OpaqueMode);
+      pixmapPainter.drawRect(0, 0, tiledPixmap.width(), tiledPixmap.height());
+      pixmapPainter.end();
+      // ### workaround for borked XRENDER
+      tiledPixmap_ = QPixmap::fromImage(tiledPixmap.toImage());
+      tiledBg_     = bg;
+    }
+
+    return tiledPixmap_;
+  }
+
  private:
   CQRubberBand *band_ { nullptr };
   QColor        color_;
+
+  mutable QPixmap tiledPixmap_; // cached pattern pixmap
+  mutable QColor  tiledBg_;     // cached pattern background
 };
 
 //------
@@ -1,11 +1,13 @@
 #include <CQSplitterArea.h>
 #include <CQPaletteArea.h>
+#include <CQPaletteDropIndicator.h>
 
 #include <QMainWindow>
 #include <QSplitter>
 #include <QStylePainter>
 #include <QStyleOption>
 #include <QMouseEvent>
+#include <QTimer>
 
 #include <cassert>
 #include <iostream>
@@ -121,11 +123,25 @@ CQSplitterHandle(CQSplitterArea *area) :
 {
   setObjectName("handle");
 
+  moveTimer_ = new QTimer(this);
+
+  moveTimer_->setObjectName("moveTimer");
+  moveTimer_->setSingleShot(true);
+  moveTimer_->setInterval(16); // ~60Hz
+
+  connect(moveTimer_, SIGNAL(timeout()), this, SLOT(moveTimerSlot()));
+
   setFixedHeight(5);
 
   setCursor(Qt::SplitHCursor);
 }
 
+CQSplitterHandle::
+~CQSplitterHandle()
+{
+  delete guide_;
+}
+
 void
 CQSplitterHandle::
 updateState()
@@ -177,6 +193,9 @@ mousePressEvent(QMouseEvent *e)
   mouseState_.pressed  = true;
   mouseState_.pressPos = e->globalPos();
 
+  movePending_ = false;
+  guideDelta_  = 0;
+
   update();
 }
 
@@ -186,31 +205,126 @@ mouseMoveEvent(QMouseEvent *e)
 {
   if (! mouseState_.pressed) return;
 
-  if (area_->isVerticalDockArea()) {
-    int dx = e->globalPos().x() - mouseState_.pressPos.x();
+  switch (area_->resizeMode()) {
+    case CQSplitterArea::ResizeMode::Immediate:
+      applyMove(e->globalPos());
 
-    if (dx) {
-      if (area()->palette()->moveSplitter(dx))
-        mouseState_.pressPos = e->globalPos();
-    }
+      update();
+
+      break;
+    case CQSplitterArea::ResizeMode::FramePaced:
+      // apply latest position at most once per frame
+      movePos_     = e->globalPos();
+      movePending_ = true;
+
+      if (! moveTimer_->isActive())
+        moveTimer_->start();
+
+      break;
+    case CQSplitterArea::ResizeMode::Guide:
+      updateGuide(e->globalPos());
+
+      break;
   }
-  else {
-    int dy = e->globalPos().y() - mouseState_.pressPos.y();
+}
 
-    if (dy) {
-      if (area()->palette()->moveSplitter(dy))
-        mouseState_.pressPos = e->globalPos();
-    }
+void
+CQSplitterHandle::
+mouseReleaseEvent(QMouseEvent *)
+{
+  // flush pending move
+  if (movePending_) {
+    moveTimer_->stop();
+
+    applyMove(movePos_);
+
+    movePending_ = false;
+  }
+
+  // apply guide position
+  if (guide_ && guide_->isVisible()) {
+    guide_->hide();
+
+    if (guideDelta_)
+      area()->palette()->moveSplitter(guideDelta_);
+
+    guideDelta_ = 0;
   }
 
+  mouseState_.pressed = false;
+
   update();
 }
 
+int
+CQSplitterHandle::
+moveDelta(const QPoint &gpos) const
+{
+  if (area_->isVerticalDockArea())
+    return gpos.x() - mouseState_.pressPos.x();
+  else
+    return gpos.y() - mouseState_.pressPos.y();
+}
+
 void
 CQSplitterHandle::
-mouseReleaseEvent(QMouseEvent *)
+applyMove(const QPoint &gpos)
 {
-  mouseState_.pressed = false;
+  int d = moveDelta(gpos);
+
+  if (d) {
+    if (area()->palette()->moveSplitter(d))
+      mouseState_.pressPos = gpos;
+  }
+}
+
+void
+CQSplitterHandle::
+updateGuide(const QPoint &gpos)
+{
+  // keep guide in palette min/max size range
+  guideDelta_ = area()->palette()->clampSplitterDelta(moveDelta(gpos));
+
+  // non-native child overlay of top level (main window or detached area) so
+  // moving it only repaints old and new rects (no window manager round trip)
+  QWidget *parent = window();
+
+  if (guide_ && guide_->parentWidget() != parent) {
+    delete guide_;
+
+    guide_ = nullptr;
+  }
+
+  if (! guide_) {
+    guide_ = new CQPaletteDropIndicator(parent);
+
+    guide_->setObjectName("guide");
+
+    guide_->setColor(palette().color(QPalette::Highlight));
+
+    guide_->setInnerBorder(false);
+  }
+
+  QRect rect(mapToGlobal(QPoint(0, 0)), size());
+
+  if (area_->isVerticalDockArea())
+    rect.translate(guideDelta_, 0);
+  else
+    rect.translate(0, guideDelta_);
+
+  guide_->setGlobalRect(rect);
+}
+
+void
+CQSplitterHandle::
+moveTimerSlot()
+{
+  if (! movePending_ || ! mouseState_.pressed)
+    return;
+
+  movePending_ = false;
+
+  applyMove(movePos_);
 
   update();
 }
@@ -10,19 +10,93 @@
 #include <QDrag>
 #include <QMimeData>
 
+#include <algorithm>
 #include <cassert>
+#include <cstring>
+#include <map>
 
 namespace {
-static const char *dragId     = "CQTabBarDragId";
-static const char *mimeId     = "CQTabBarMimeId";
-static const char *mimeNameId = "CQTabBarMimeNameId";
-static const char *mimeTabId  = "CQTabBarMimeTabId";
+static const char *mimeId = "application/x-cqtabbar-tab";
+
+// tab drag payload (binary, only valid in source process)
+struct DragPayload {
+  qint64  pid      { 0 };
+  quint32 tabBarId { 0 };
+  qint32  tabIndex { -1 };
+};
+
+// get next unique tab bar id
+uint newTabBarId()
+{
+  static uint lastId = 0;
+
+  return ++lastId;
+}
+
+// key for rotated icon cache
+struct RotatedIconKey {
+  qint64 iconKey { 0 };
+  int    angle   { 0 };
+  int    width   { 0 };
+  int    height  { 0 };
+  qreal  dpr     { 1.0 };
+
+  bool operator<(const RotatedIconKey &rhs) const {
+    if (iconKey != rhs.iconKey) return (iconKey < rhs.iconKey);
+    if (angle   != rhs.angle  ) return (angle   < rhs.angle  );
+    if (width   != rhs.width  ) return (width   < rhs.width  );
+    if (height  != rhs.height ) return (height  < rhs.height );
+    return (dpr < rhs.dpr);
+  }
+};
+
+// get rotated icon for painting device pixel ratio
+// (shared by all tab bars so icons are only rotated once per process)
+QIcon rotatedIcon(const QIcon &icon, int angle, const QSize &size, qreal dpr)
+{
+  enum { MAX_ROTATED_ICONS = 512 };
+
+  using RotatedIcons = std::map<RotatedIconKey, QIcon>;
+
+  static RotatedIcons rotatedIcons;
+
+  RotatedIconKey key;
+
+  key.iconKey = icon.cacheKey();
+  key.angle   = angle;
+  key.width   = size.width ();
+  key.height  = size.height();
+  key.dpr     = dpr;
+
+  auto p = rotatedIcons.find(key);
+
+  if (p != rotatedIcons.end())
+    return (*p).second;
+
+  // icons are never removed individually so limit size
+  if (rotatedIcons.size() >= MAX_ROTATED_ICONS)
+    rotatedIcons.clear();
+
+  QTransform t;
+
+  t.rotate(angle);
+
+  QPixmap pixmap = icon.pixmap(size*dpr).transformed(t);
+
+  pixmap.setDevicePixelRatio(dpr);
+
+  QIcon icon1(pixmap);
+
+  rotatedIcons[key] = icon1;
+
+  return icon1;
+}
 }
 
 // create tab bar
 CQTabBar::
 CQTabBar(QWidget *parent) :
- QWidget(parent)
+ QWidget(parent), id_(newTabBarId())
 {
   setObjectName("tabBar");
 
@@ -59,8 +133,12 @@ clear()
     delete button;
 
   buttons_.clear();
+  tabPos_ .clear();
 
+  nextIndex_    = 0;
   currentIndex_ = -1;
+
+  invalidateLayout();
 }
 
 // add tab for widget with specified text
@@ -123,17 +201,17 @@ int
 CQTabBar::
 insertTab(int ind, CQTabBarButton *button)
 {
-  buttons_.push_back(nullptr);
-
-  for (int i = int(buttons_.size() - 1); i > ind; --i)
-    buttons_[size_t(i)] = buttons_[size_t(i - 1)];
+  int pos = std::min(std::max(ind, 0), count());
 
-  buttons_[size_t(ind)] = button;
+  buttons_.insert(buttons_.begin() + pos, button);
 
-  int index = int(buttons_.size()) - 1;
+  // index is stable for the lifetime of the tab
+  int index = nextIndex_++;
 
   button->setIndex(index);
 
+  updateTabPos(pos);
+
   // update current
   if (! allowNoTab() && currentIndex() < 0)
     setCurrentIndex(index);
@@ -167,7 +245,11 @@ removeTab(int ind)
 
   auto *button = buttons_[size_t(pos)];
 
-  buttons_[size_t(pos)] = nullptr;
+  buttons_.erase(buttons_.begin() + pos);
+
+  tabPos_.erase(ind);
+
+  updateTabPos(pos);
 
   delete button;
 
@@ -181,21 +263,39 @@ removeTab(int ind)
   update();
 }
 
-// get number of tabs
-int
+// begin batched tab changes
+void
 CQTabBar::
-count() const
+beginUpdate()
 {
-  int n = 0;
+  ++updateDepth_;
+}
 
-  for (auto p = buttons_.begin(); p != buttons_.end(); ++p) {
-    auto *button = *p;
-    if (! button) continue;
+// end batched tab changes (update sizes once if changed)
+void
+CQTabBar::
+endUpdate()
+{
+  assert(updateDepth_ > 0);
+
+  if (--updateDepth_ > 0)
+    return;
 
-    ++n;
+  if (sizesPending_) {
+    sizesPending_ = false;
+
+    updateSizes();
+
+    update();
   }
+}
 
-  return n;
+// get number of tabs
+int
+CQTabBar::
+count() const
+{
+  return int(buttons_.size());
 }
 
 // get tab at count
@@ -203,19 +303,10 @@ int
 CQTabBar::
 tabInd(int i) const
 {
-  int n = 0;
+  if (i < 0 || i >= count())
+    return -1;
 
-  for (auto p = buttons_.begin(); p != buttons_.end(); ++p) {
-    auto *button = *p;
-    if (! button) continue;
-
-    if (n == i)
-      return button->index();
-
-    ++n;
-  }
-
-  return -1;
+  return buttons_[size_t(i)]->index();
 }
 
 // set current tab
@@ -223,19 +314,23 @@ void
 CQTabBar::
 setCurrentIndex(int ind)
 {
-  // button array can contain empty slots so ensure the requested one is valid
+  // ensure the requested tab is valid
   auto *button = tabButton(ind);
   if (! button) return;
 
   // process if changed
   if (ind != currentIndex_) {
+    int oldIndex = currentIndex_;
+
     currentIndex_ = ind;
 
     // if one tab must be active and nothing active then use first non-null button
     if (! allowNoTab() && currentIndex_ < 0 && count() > 0)
       currentIndex_ = 0;
 
-    update();
+    // redraw old and new current tabs
+    updateTab(oldIndex);
+    updateTab(currentIndex_);
 
     Q_EMIT currentChanged(currentIndex_);
   }
@@ -249,7 +344,7 @@ getTabIndex(QWidget *w) const
   for (auto p = buttons_.begin(); p != buttons_.end(); ++p) {
     auto *button = *p;
 
-    if (button && button->widget() == w)
+    if (button->widget() == w)
       return button->index();
   }
 
@@ -267,6 +362,8 @@ setPosition(const Position &position)
 
   position_ = position;
 
+  updateSizes();
+
   update();
 }
 
@@ -288,6 +385,9 @@ setButtonStyle(const Qt::ToolButtonStyle &buttonStyle)
 {
   buttonStyle_ = buttonStyle;
 
+  for (auto *button : buttons_)
+    button->invalidateSize();
+
   updateSizes();
 
   update();
@@ -405,10 +505,11 @@ setTabPending(int ind, bool pending)
 {
   auto *button = tabButton(ind);
 
-  if (button)
+  if (button && button->pending() != pending) {
     button->setPending(pending);
 
-  update();
+    updateTab(ind);
+  }
 }
 
 // get tab data
@@ -440,14 +541,12 @@ CQTabBarButton *
 CQTabBar::
 tabButton(int ind) const
 {
-  for (auto p = buttons_.begin(); p != buttons_.end(); ++p) {
-    auto *button = *p;
+  auto p = tabPos_.find(ind);
 
-    if (button && button->index() == ind)
-      return button;
-  }
+  if (p == tabPos_.end())
+    return nullptr;
 
-  return nullptr;
+  return buttons_[size_t((*p).second)];
 }
 
 // get array pos for tab
@@ -455,16 +554,20 @@ int
 CQTabBar::
 tabButtonPos(int ind) const
 {
-  for (int i = 0; i < int(buttons_.size()); ++i) {
-    auto *button = buttons_[size_t(i)];
+  auto p = tabPos_.find(ind);
 
-    if (button && button->index() == ind)
-      return i;
-  }
+  assert(p != tabPos_.end());
 
-  assert(false);
+  return (*p).second;
+}
 
-  return -1;
+// update tab index to array pos map for buttons at or after array pos
+void
+CQTabBar::
+updateTabPos(int pos)
+{
+  for (int i = pos; i < count(); ++i)
+    tabPos_[buttons_[size_t(i)]->index()] = i;
 }
 
 // get widget for tab
@@ -483,28 +586,16 @@ tabWidget(int ind) const
 // draw tab buttons
 void
 CQTabBar::
-paintEvent(QPaintEvent *)
+paintEvent(QPaintEvent *e)
 {
-  QStylePainter stylePainter(this);
-
-  //------
-
-  // calculate width and height of region
-  int xo = 0;
-
-  if (! isFlowTabs() && offset_ > 0) {
-    int offset = offset_;
-
-    for (auto p = buttons_.begin(); offset > 0 && p != buttons_.end(); ++p) {
-      auto *button = *p;
+  // ensure button geometry is up to date
+  updateLayout();
 
-      if (! button || ! button->visible()) continue;
+  const QRegion &region = e->region();
 
-      xo += button->width();
+  QStylePainter stylePainter(this);
 
-      --offset;
-    }
-  }
+  //------
 
   int w = width ();
   int h = height();
@@ -531,65 +622,11 @@ paintEvent(QPaintEvent *)
 
   baseStyle.initFrom(this);
 
-  // calculate button geometry and first/last tab buttons
-  CQTabBarButton *firstButton = nullptr;
-  CQTabBarButton *lastButton  = nullptr;
-
-  int x = -xo;
-  int y = 0;
+  // update base line rectangle
+  auto *currentButton = tabButton(currentIndex());
 
-  for (auto p = buttons_.begin(); p != buttons_.end(); ++p) {
-    auto *button = *p;
-
-    if (! button || ! button->visible()) continue;
-
-    // calc button width
-    int w1 = button->width();
-
-    // flow to next row if needed
-    if (isFlowTabs() && firstButton) {
-      if (isVertical()) {
-        if (x + w1 > h) {
-          x  = 0;
-          y += button->height();
-        }
-      }
-      else {
-        if (x + w1 > w) {
-          x  = 0;
-          y += button->height();
-        }
-      }
-    }
-
-    if (firstButton == nullptr)
-      firstButton = button;
-    else
-      lastButton = button;
-
-    // calculate and store button rectangle
-    QRect r;
-
-    if (isVertical())
-      r = QRect(y, x, h_, w1);
-    else
-      r = QRect(x, y, w1, h_);
-
-    button->setRect(r);
-
-    // update base line rectangle
-    if (button->index() == currentIndex())
-      baseStyle.selectedTabRect = r;
-
-    //-----
-
-    x += w1;
-  }
-
-  if (firstButton)
-    y += firstButton->height();
-
-  buttonsHeight_ = y;
+  if (currentButton && currentButton->visible())
+    baseStyle.selectedTabRect = currentButton->rect();
 
   //---
 
@@ -610,12 +647,13 @@ paintEvent(QPaintEvent *)
   //------
 
   // draw buttons
-  x = -xo;
-
   for (auto p = buttons_.begin(); p != buttons_.end(); ++p) {
     auto *button = *p;
 
-    if (! button || ! button->visible()) continue;
+    if (! button->visible()) continue;
+
+    // skip tabs outside the update region
+    if (! region.intersects(tabUpdateRect(button))) continue;
 
     //----
 
@@ -653,9 +691,9 @@ paintEvent(QPaintEvent *)
 
     tabStyle.iconSize = iconSize();
 
-    if      (button == firstButton)
+    if      (button->index() == firstIndex_)
       tabStyle.position = QStyleOptionTab::Beginning;
-    else if (button == lastButton)
+    else if (button->index() == lastIndex_)
       tabStyle.position = QStyleOptionTab::End;
     else
       tabStyle.position = QStyleOptionTab::Middle;
@@ -667,11 +705,10 @@ paintEvent(QPaintEvent *)
       tabStyle.palette.setColor(QPalette::Button, pendingColor());
 
     // draw button
-    stylePainter.drawControl(QStyle::CE_TabBarTab, tabStyle);
-
-    //-----
-
-    x += button->width();
+    if (isPixmapCache())
+      drawCachedTab(&stylePainter, button, tabStyle);
+    else
+      stylePainter.drawControl(QStyle::CE_TabBarTab, tabStyle);
   }
 
   // update scroll buttons
@@ -681,6 +718,74 @@ paintEvent(QPaintEvent *)
   }
 }
 
+// draw tab from cached pixmap (rendered with style if key has changed)
+void
+CQTabBar::
+drawCachedTab(QPainter *painter, CQTabBarButton *button, const QStyleOptionTab &opt)
+{
+  // styles can draw outside tab rect so add margin
+  int m = TAB_BORDER;
+
+  const QRect &r = opt.rect;
+
+  CQTabBarButton::PixmapKey key;
+
+  key.text       = opt.text;
+  key.iconKey    = opt.icon.cacheKey();
+  key.shape      = int(opt.shape);
+  key.state      = int(opt.state);
+  key.position   = int(opt.position);
+  key.paletteKey = palette().cacheKey();
+  key.pendingRgb = (button->pending() ? pendingColor().rgba() : 0);
+  key.size       = r.size();
+  key.dpr        = devicePixelRatioF();
+
+  if (button->tabPixmap().isNull() || key != button->tabPixmapKey()) {
+    QPixmap pixmap((r.size() + QSize(2*m, 2*m))*key.dpr);
+
+    pixmap.setDevicePixelRatio(key.dpr);
+
+    pixmap.fill(Qt::transparent);
+
+    QPainter pixmapPainter(&pixmap);
+
+    QStyleOptionTab opt1 = opt;
+
+    opt1.rect = QRect(m, m, r.width(), r.height());
+
+    style()->drawControl(QStyle::CE_TabBarTab, &opt1, &pixmapPainter, this);
+
+    pixmapPainter.end();
+
+    button->setTabPixmap(key, pixmap);
+  }
+
+  painter->drawPixmap(r.topLeft() - QPoint(m, m), button->tabPixmap());
+}
+
+// set use cached tab pixmaps for drawing
+void
+CQTabBar::
+setPixmapCache(bool b)
+{
+  pixmapCache_ = b;
+
+  // release pixmaps when disabled
+  if (! pixmapCache_)
+    clearTabPixmaps();
+
+  update();
+}
+
+// release cached tab pixmaps
+void
+CQTabBar::
+clearTabPixmaps()
+{
+  for (auto *button : buttons_)
+    button->setTabPixmap(CQTabBarButton::PixmapKey(), QPixmap());
+}
+
 // handle resize
 void
 CQTabBar::
@@ -689,11 +794,46 @@ resizeEvent(QResizeEvent *)
   updateSizes();
 }
 
-// update size of tab area
+// handle font/style change
 void
 CQTabBar::
-updateSizes()
+changeEvent(QEvent *e)
+{
+  if (e->type() == QEvent::FontChange || e->type() == QEvent::StyleChange) {
+    if (e->type() == QEvent::FontChange) {
+      for (auto *button : buttons_)
+        button->invalidateSize();
+    }
+
+    // pixmap key has no font or style so rendered tabs are out of date
+    clearTabPixmaps();
+
+    updateSizes();
+
+    update();
+  }
+
+  QWidget::changeEvent(e);
+}
+
+// mark cached tab geometry as invalid
+void
+CQTabBar::
+invalidateLayout()
 {
+  layoutValid_ = false;
+}
+
+// update cached tab geometry (button rects, clip count and size hint width)
+void
+CQTabBar::
+updateLayout() const
+{
+  if (layoutValid_)
+    return;
+
+  layoutValid_ = true;
+
   // calculate width and height of region
   QFontMetrics fm(font());
 
@@ -706,74 +846,179 @@ updateSizes()
   else
     bh = qMin(bh, height() - RESIZE_WIDTH);
 
-  int x  = 0;
-  int y  = 0;
-  int bw = 0;
+  iw_ = iw;
+  h_  = bh;
 
   int w = width ();
   int h = height();
 
-  clipNum_ = 0;
+  int l = (isVertical() ? h : w);
 
-  CQTabBarButton *firstButton = nullptr;
+  //---
+
+  // calc clipped buttons and size hint width (unscrolled)
+  int x  = 0;
+  int bw = 0;
+
+  clipNum_       = 0;
+  hintWidth_     = 0;
+  firstIndex_    = -1;
+  lastIndex_     = -1;
 
   for (auto p = buttons_.begin(); p != buttons_.end(); ++p) {
     auto *button = *p;
 
-    if (! button || ! button->visible()) continue;
+    if (! button->visible()) continue;
 
-    if (! firstButton)
-      firstButton = button;
+    int w1 = button->width();
 
-    bw = x + button->width();
+    bw = x + w1;
 
-    if (isVertical()) {
-      if (bw > h) {
-        if (isFlowTabs()) {
-          if (firstButton) {
-            x  = 0;
-            y += button->height();
-          }
-        }
-        else {
-          ++clipNum_;
-        }
-      }
+    if (bw > l) {
+      if (isFlowTabs())
+        x = 0;
+      else
+        ++clipNum_;
     }
-    else {
-      if (bw > w) {
-        if (isFlowTabs()) {
-          if (firstButton) {
-            x  = 0;
-            y += button->height();
-          }
-        }
-        else {
-          ++clipNum_;
-        }
+
+    x          += w1;
+    hintWidth_ += w1;
+  }
+
+  w_ = bw;
+
+  //---
+
+  // calculate scroll offset
+  int xo = 0;
+
+  if (! isFlowTabs() && offset_ > 0) {
+    int offset = offset_;
+
+    for (auto p = buttons_.begin(); offset > 0 && p != buttons_.end(); ++p) {
+      auto *button = *p;
+
+      if (! button->visible()) continue;
+
+      xo += button->width();
+
+      --offset;
+    }
+  }
+
+  //---
+
+  // calculate button geometry and first/last tab buttons
+  CQTabBarButton *firstButton = nullptr;
+
+  x = -xo;
+
+  int y = 0;
+
+  for (auto p = buttons_.begin(); p != buttons_.end(); ++p) {
+    auto *button = *p;
+
+    if (! button->visible()) continue;
+
+    // calc button width
+    int w1 = button->width();
+
+    // flow to next row if needed
+    if (isFlowTabs() && firstButton) {
+      if (x + w1 > l) {
+        x  = 0;
+        y += button->height();
       }
     }
 
-    x += button->width();
+    if (firstButton == nullptr) {
+      firstButton = button;
+      firstIndex_ = button->index();
+    }
+    else
+      lastIndex_ = button->index();
+
+    // calculate and store button rectangle
+    QRect r;
+
+    if (isVertical())
+      r = QRect(y, x, h_, w1);
+    else
+      r = QRect(x, y, w1, h_);
+
+    button->setRect(r);
+
+    //-----
+
+    x += w1;
   }
 
   if (firstButton)
     y += firstButton->height();
 
-  iw_ = iw;
-  w_  = bw;
-  h_  = bh;
-
   buttonsHeight_ = y;
+}
+
+// update size of tab area
+void
+CQTabBar::
+updateSizes()
+{
+  invalidateLayout();
+
+  // defer layout and scroll update to end of batched update
+  if (updateDepth_ > 0) {
+    sizesPending_ = true;
+    return;
+  }
+
+  updateLayout();
 
   //-----
 
+  int offset = offset_;
+
   // update scroll if clipped
   if (! isFlowTabs())
     showScrollButtons(clipNum_ > 0);
 
   if (offset_ > clipNum_)
     offset_ = clipNum_;
+
+  // button rects depend on scroll offset
+  if (offset_ != offset)
+    invalidateLayout();
+}
+
+// redraw single tab
+void
+CQTabBar::
+updateTab(int ind)
+{
+  auto *button = tabButton(ind);
+
+  if (! button || ! button->visible())
+    return;
+
+  update(tabUpdateRect(button));
+}
+
+// get redraw rectangle for tab (full depth of bar to include tab base)
+QRect
+CQTabBar::
+tabUpdateRect(CQTabBarButton *button) const
+{
+  updateLayout();
+
+  const QRect &r = button->rect();
+
+  // styles can draw selected tab slightly outside its rect
+  int m = TAB_BORDER;
+
+  if (isVertical())
+    return QRect(0, r.top() - m, width(), r.height() + 2*m);
+  else
+    return QRect(r.left() - m, 0, r.width() + 2*m, height());
 }
 
 // update scroll buttons
@@ -832,6 +1077,8 @@ lscrollSlot()
   if (offset_ < 0)
     offset_ = 0;
 
+  invalidateLayout();
+
   update();
 }
 
@@ -846,6 +1093,8 @@ rscrollSlot()
   if (offset_ > clipNum_)
     offset_ = clipNum_;
 
+  invalidateLayout();
+
   update();
 }
 
@@ -887,15 +1136,9 @@ sizeHint() const
   int iw = iconSize().width();
   int h  = qMax(iw, fm.height()) + TAB_BORDER + RESIZE_WIDTH;
 
-  int w = 0;
-
-  for (auto p = buttons_.begin(); p != buttons_.end(); ++p) {
-    auto *button = *p;
-
-    if (! button || ! button->visible()) continue;
+  updateLayout();
 
-    w += button->width();
-  }
+  int w = hintWidth_;
 
   if (isVertical())
     return QSize(h, w);
@@ -921,9 +1164,32 @@ void
 CQTabBar::
 setPressPoint(const QPoint &p)
 {
+  int oldIndex = pressIndex_;
+
   pressed_    = true;
   pressPos_   = p;
   pressIndex_ = tabAt(pressPos_);
+
+  if (pressIndex_ != oldIndex) {
+    updateTab(oldIndex);
+    updateTab(pressIndex_);
+  }
+}
+
+// set tab under mouse
+void
+CQTabBar::
+setMoveIndex(int ind)
+{
+  if (ind == moveIndex_)
+    return;
+
+  int oldIndex = moveIndex_;
+
+  moveIndex_ = ind;
+
+  updateTab(oldIndex);
+  updateTab(moveIndex_);
 }
 
 // handle mouse press
@@ -931,10 +1197,8 @@ void
 CQTabBar::
 mousePressEvent(QMouseEvent *e)
 {
-  // init press state and redraw
+  // init press state (redraws changed tabs)
   setPressPoint(e->pos());
-
-  update();
 }
 
 // handle mouse move (while pressed)
@@ -962,12 +1226,15 @@ mouseMoveEvent(QMouseEvent *e)
 
       auto *mimeData = new QMimeData;
 
-      // use unique id for our mime data and store source palette type
-      auto numStr = QString("%1").arg(pressIndex_);
+      // use unique format for our mime data and store source tab bar id and tab index
+      DragPayload payload;
+
+      payload.pid      = QCoreApplication::applicationPid();
+      payload.tabBarId = id_;
+      payload.tabIndex = pressIndex_;
 
-      mimeData->setData(mimeId    , dragId);
-      mimeData->setData(mimeNameId, objectName().toLatin1());
-      mimeData->setData(mimeTabId , numStr.toLatin1());
+      mimeData->setData(mimeId,
+        QByteArray(reinterpret_cast<const char *>(&payload), sizeof(payload)));
 
       drag->setMimeData(mimeData);
 
@@ -975,7 +1242,8 @@ mouseMoveEvent(QMouseEvent *e)
     }
   }
 
-  update();
+  // redraw tabs whose mouse over state changed
+  setMoveIndex(tabAt(e->pos()));
 }
 
 // handle mouse release
@@ -986,6 +1254,8 @@ mouseReleaseEvent(QMouseEvent *e)
   // reset pressed state
   pressed_ = false;
 
+  int oldPressIndex = pressIndex_;
+
   // check if new tab button is pressed
   pressIndex_ = tabAt(e->pos());
 
@@ -1001,8 +1271,17 @@ mouseReleaseEvent(QMouseEvent *e)
   // signal tab button pressed
   Q_EMIT tabPressedSignal(pressIndex_, ! isCurrent);
 
-  // redraw
-  update();
+  // redraw old and new pressed tabs
+  updateTab(oldPressIndex);
+  updateTab(pressIndex_);
+}
+
+// handle mouse leave
+void
+CQTabBar::
+leaveEvent(QEvent *)
+{
+  setMoveIndex(-1);
 }
 
 // handle drag enter event
@@ -1010,10 +1289,10 @@ void
 CQTabBar::
 dragEnterEvent(QDragEnterEvent *event)
 {
-  QString name;
-  int     fromIndex;
+  // parse drag data once for following move and drop events
+  dragData_.valid = dragValid(event->mimeData(), dragData_.tabBarId, dragData_.tabIndex);
 
-  if (! dragValid(event->mimeData(), name, fromIndex)) {
+  if (! dragData_.valid) {
     event->ignore();
     return;
   }
@@ -1026,40 +1305,49 @@ void
 CQTabBar::
 dragMoveEvent(QDragMoveEvent *event)
 {
-  QString name;
-  int     fromIndex;
-
-  if (! dragValid(event->mimeData(), name, fromIndex)) {
+  if (! dragData_.valid) {
     event->ignore();
     return;
   }
 
-  if (dragPosValid(name, event->pos()))
+  if (dragPosValid(dragData_.tabBarId, event->pos()))
     event->acceptProposedAction();
   else
     event->ignore();
 }
 
+// handle drag leave
+void
+CQTabBar::
+dragLeaveEvent(QDragLeaveEvent *)
+{
+  dragData_ = DragData();
+}
+
 // handle drop event
 void
 CQTabBar::
 dropEvent(QDropEvent *event)
 {
-  QString name;
-  int     fromIndex;
+  DragData dragData = dragData_;
+
+  dragData_ = DragData();
 
-  if (! dragValid(event->mimeData(), name, fromIndex)) {
+  if (! dragData.valid) {
     event->ignore();
     return;
   }
 
-  if (! dragPosValid(name, event->pos()))
+  uint fromId    = dragData.tabBarId;
+  int  fromIndex = dragData.tabIndex;
+
+  if (! dragPosValid(fromId, event->pos()))
     return;
 
   // get index at release position
   int toIndex = tabAt(event->pos());
 
-  if (name == objectName()) {
+  if (fromId == id_) {
     // skip invalid and do nothing drops
     if (fromIndex < 0 || toIndex < 0 || fromIndex == toIndex)
       return;
@@ -1076,15 +1364,21 @@ dropEvent(QDropEvent *event)
     button1->setIndex(toIndex);
     button2->setIndex(fromIndex);
 
-    if      (fromIndex == currentIndex()) setCurrentIndex(toIndex);
-    else if (toIndex   == currentIndex()) setCurrentIndex(fromIndex);
+    invalidateLayout();
 
+    // redraw swapped tabs (current index may be unchanged)
+    update();
+
+    // notify before current change so listeners see new tab order
     Q_EMIT tabMoved(fromIndex, toIndex);
 
+    if      (fromIndex == currentIndex()) setCurrentIndex(toIndex);
+    else if (toIndex   == currentIndex()) setCurrentIndex(fromIndex);
+
     event->acceptProposedAction();
   }
   else {
-    Q_EMIT tabMovePageSignal(name, fromIndex, this->objectName(), toIndex);
+    Q_EMIT tabMovePageSignal(fromId, fromIndex, id_, toIndex);
 
     event->acceptProposedAction();
   }
@@ -1093,24 +1387,26 @@ dropEvent(QDropEvent *event)
 // is drag valid
 bool
 CQTabBar::
-dragValid(const QMimeData *m, QString &name, int &num) const
+dragValid(const QMimeData *m, uint &tabBarId, int &num) const
 {
-  // Only accept if it's our request
-  auto formats = m->formats();
+  // Only accept if it's our request (from this process)
+  if (! m || ! m->hasFormat(mimeId))
+    return false;
 
-  if (! formats.contains(mimeId) || m->data(mimeId) != dragId)
+  QByteArray data = m->data(mimeId);
+
+  if (data.size() != int(sizeof(DragPayload)))
     return false;
 
-  assert(formats.contains(mimeTabId));
-  assert(formats.contains(mimeNameId));
+  DragPayload payload;
 
-  name = m->data(mimeNameId).data();
+  memcpy(&payload, data.constData(), sizeof(payload));
 
-  auto *numStr = m->data(mimeTabId).data();
+  if (payload.pid != QCoreApplication::applicationPid())
+    return false;
 
-  bool ok;
-  num = QString(numStr).toInt(&ok);
-  if (! ok) return false;
+  tabBarId = payload.tabBarId;
+  num      = payload.tabIndex;
 
   return true;
 }
@@ -1118,10 +1414,10 @@ dragValid(const QMimeData *m, QString &name, int &num) const
 // is drag position valid
 bool
 CQTabBar::
-dragPosValid(const QString &name, const QPoint &pos) const
+dragPosValid(uint tabBarId, const QPoint &pos) const
 {
   // drag in same tab bar must be to another tab
-  if (name == this->objectName()) {
+  if (tabBarId == id_) {
     int ind = tabAt(pos);
 
     if (ind < 0)
@@ -1136,10 +1432,12 @@ int
 CQTabBar::
 tabAt(const QPoint &point) const
 {
+  updateLayout();
+
   for (auto p = buttons_.begin(); p != buttons_.end(); ++p) {
     auto *button = *p;
 
-    if (! button || ! button->visible()) continue;
+    if (! button->visible()) continue;
 
     if (button->rect().contains(point))
       return button->index();
@@ -1148,6 +1446,21 @@ tabAt(const QPoint &point) const
   return -1;
 }
 
+// get rectangle of tab
+QRect
+CQTabBar::
+tabRect(int ind) const
+{
+  updateLayout();
+
+  auto *button = tabButton(ind);
+
+  if (! button || ! button->visible())
+    return QRect();
+
+  return button->rect();
+}
+
 // get icon size
 QSize
 CQTabBar::
@@ -1163,6 +1476,8 @@ setIconSize(const QSize &size)
 {
   iconSize_ = size;
 
+  updateSizes();
+
   update();
 }
 
@@ -1210,6 +1525,8 @@ CQTabBarButton::
 setText(const QString &text)
 {
   text_ = text;
+
+  invalidateSize();
 }
 
 // set button icon
@@ -1219,6 +1536,8 @@ setIcon(const QIcon &icon)
 {
   icon_ = icon;
 
+  invalidateSize();
+
   // ensure new icon causes recalc
   if (iconPosition_ != Position::North && iconPosition_ != Position::South)
     iconPosition_ = Position::North;
@@ -1240,18 +1559,16 @@ positionIcon(CQTabBar::Position pos) const
   if (pos == Position::North || pos == Position::South)
     return icon_;
 
-  if (pos == iconPosition_)
+  qreal dpr = bar_->devicePixelRatioF();
+
+  if (pos == iconPosition_ && dpr == iconDpr_)
     return positionIcon_;
 
   iconPosition_ = pos;
+  iconDpr_      = dpr;
 
-  QTransform t;
-
-  auto p = pixmap();
-
-  t.rotate(iconPosition_ == Position::West ? 90 : -90);
-
-  positionIcon_ = QIcon(p.transformed(t));
+  positionIcon_ = rotatedIcon(icon_, iconPosition_ == Position::West ? 90 : -90,
+                              bar_->iconSize(), dpr);
 
   return positionIcon_;
 }
@@ -1307,6 +1624,15 @@ setRect(const QRect &r)
   r_ = r;
 }
 
+// set rendered tab pixmap
+void
+CQTabBarButton::
+setTabPixmap(const PixmapKey &key, const QPixmap &pixmap)
+{
+  tabPixmapKey_ = key;
+  tabPixmap_    = pixmap;
+}
+
 // get tab icon pixmap
 QPixmap
 CQTabBarButton::
@@ -1320,12 +1646,16 @@ int
 CQTabBarButton::
 width() const
 {
+  auto buttonStyle = bar_->buttonStyle();
+
+  // use cached value if button style and icon width unchanged
+  if (width_ >= 0 && buttonStyle == sizeStyle_ && bar_->iconWidth() == sizeIconWidth_)
+    return width_;
+
   QFontMetrics fm(bar_->font());
 
   //------
 
-  auto buttonStyle = bar_->buttonStyle();
-
   int w = 0;
 
   if      (buttonStyle == Qt::ToolButtonTextOnly)
@@ -1335,6 +1665,10 @@ width() const
   else
     w = bar_->iconWidth() + fm.horizontalAdvance(text()) + 32;
 
+  width_         = w;
+  sizeStyle_     = buttonStyle;
+  sizeIconWidth_ = bar_->iconWidth();
+
   return w;
 }
 
@@ -1342,9 +1676,22 @@ int
 CQTabBarButton::
 height() const
 {
-  QFontMetrics fm(bar_->font());
+  if (height_ < 0) {
+    QFontMetrics fm(bar_->font());
+
+    height_ = fm.height() + TAB_BORDER;
+  }
+
+  return height_;
+}
 
-  return fm.height() + TAB_BORDER;
+// invalidate cached width and height
+void
+CQTabBarButton::
+invalidateSize()
+{
+  width_  = -1;
+  height_ = -1;
 }
 
 //---------